@@ -0,0 +1,343 @@
+// benchmark.c
+
+// clock_gettime() and CLOCK_MONOTONIC are POSIX, so they are not declared by a strict C11 <time.h> without this
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "network.h"
+#include "benchmark.h"
+
+
+// Gets the time from the performance counter on Windows, or from the monotonic clock everywhere else
+uint64_t get_monotonic_nanoseconds() {
+#ifdef _WIN32
+	LARGE_INTEGER counter; // The current value of the performance counter
+	LARGE_INTEGER frequency; // The number of counts per second
+
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	// Whole seconds and the remainder are converted separately so that the multiplication cannot overflow
+	return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000 +
+		(uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+#else
+	struct timespec time; // The current time
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+
+	return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+#endif
+}
+
+// Compares two timings for qsort(), in increasing order
+int compare_timings(const void* first, const void* second) {
+	uint64_t first_timing = *(const uint64_t*)first; // The first timing
+	uint64_t second_timing = *(const uint64_t*)second; // The second timing
+
+	return (first_timing > second_timing) - (first_timing < second_timing);
+}
+
+// Finds a percentile of some timings as the smallest timing that at least that percentage of the timings are no more than
+uint64_t find_percentile(uint64_t* timings, int count, int percentile) {
+	int rank = (percentile * count + 99) / 100; // The position of the timing in sorted order, counting from 1
+
+	qsort(timings, count, sizeof * timings, compare_timings);
+
+	return timings[rank > 0 ? rank - 1 : 0];
+}
+
+// Times loading a network and building its routing tables. Every run loads the network again, so each build starts from
+// the same state as the first one rather than reusing routing tables that were already allocated
+bool benchmark_routing(String file_name, int algorithm, int thread_count, int warmup_runs, int trial_runs, BenchmarkResult* result) {
+	uint64_t* load_times = malloc((sizeof(uint64_t)) * trial_runs); // The time taken to load the network in each trial
+	uint64_t* build_times = malloc((sizeof(uint64_t)) * trial_runs); // The time taken to build the routing tables in each trial
+	Network* test_network; // The network loaded for the current run
+	uint64_t start; // The time that the current step started
+
+	for (int i = 0; i < warmup_runs + trial_runs; i++) {
+		start = get_monotonic_nanoseconds();
+		test_network = build_network_from_file(file_name);
+		if (test_network == NULL) {
+			free(load_times);
+			free(build_times);
+			return false;
+		}
+
+		// The warmup runs are not kept
+		if (i >= warmup_runs) {
+			load_times[i - warmup_runs] = get_monotonic_nanoseconds() - start;
+		}
+
+		start = get_monotonic_nanoseconds();
+		build_routing_tables_parallel(test_network, algorithm, thread_count);
+		if (i >= warmup_runs) {
+			build_times[i - warmup_runs] = get_monotonic_nanoseconds() - start;
+		}
+
+		result->vertices = test_network->vertices;
+		result->link_count = test_network->link_count;
+		delete_network(test_network);
+	}
+
+	result->file_name = file_name;
+	result->algorithm = algorithm;
+	result->thread_count = thread_count;
+	result->trial_count = trial_runs;
+	result->load_median = find_percentile(load_times, trial_runs, 50);
+	result->load_p95 = find_percentile(load_times, trial_runs, 95);
+	result->build_median = find_percentile(build_times, trial_runs, 50);
+	result->build_p95 = find_percentile(build_times, trial_runs, 95);
+	result->build_fastest = build_times[0]; // The build times were sorted when their percentiles were found
+
+	free(load_times);
+	free(build_times);
+
+	return true;
+}
+
+// Writes a string to a file as a JSON string, escaping the characters that JSON requires
+void write_json_string(FILE* file, String value) {
+	fputc('"', file);
+	for (int i = 0; value[i] != '\0'; i++) {
+		if (value[i] == '"' || value[i] == '\\') {
+			fputc('\\', file);
+		}
+		fputc(value[i], file);
+	}
+	fputc('"', file);
+}
+
+// Writes benchmark results as CSV or JSON. Times are written in whole nanoseconds
+void write_benchmark_results(FILE* file, BenchmarkResult* results, int count, BenchmarkFormat format) {
+	if (format == BENCHMARK_CSV) {
+		fprintf(
+			file,
+			"file,algorithm,threads,devices,links,trials,load_median_ns,load_p95_ns,build_median_ns,build_p95_ns,build_fastest_ns\n"
+		);
+
+		for (int i = 0; i < count; i++) {
+			fprintf(
+				file,
+				"%s,%s,%d,%d,%d,%d,%llu,%llu,%llu,%llu,%llu\n",
+				results[i].file_name,
+				get_algorithm_name(results[i].algorithm),
+				results[i].thread_count,
+				results[i].vertices,
+				results[i].link_count,
+				results[i].trial_count,
+				(unsigned long long)results[i].load_median,
+				(unsigned long long)results[i].load_p95,
+				(unsigned long long)results[i].build_median,
+				(unsigned long long)results[i].build_p95,
+				(unsigned long long)results[i].build_fastest
+			);
+		}
+		return;
+	}
+
+	fprintf(file, "[");
+	for (int i = 0; i < count; i++) {
+		fprintf(file, i == 0 ? "\n\t{\"file\": " : ",\n\t{\"file\": ");
+		write_json_string(file, results[i].file_name);
+		fprintf(file, ", \"algorithm\": ");
+		write_json_string(file, get_algorithm_name(results[i].algorithm));
+		fprintf(
+			file,
+			", \"threads\": %d, \"devices\": %d, \"links\": %d, \"trials\": %d, \"load_median_ns\": %llu, "
+			"\"load_p95_ns\": %llu, \"build_median_ns\": %llu, \"build_p95_ns\": %llu, \"build_fastest_ns\": %llu}",
+			results[i].thread_count,
+			results[i].vertices,
+			results[i].link_count,
+			results[i].trial_count,
+			(unsigned long long)results[i].load_median,
+			(unsigned long long)results[i].load_p95,
+			(unsigned long long)results[i].build_median,
+			(unsigned long long)results[i].build_p95,
+			(unsigned long long)results[i].build_fastest
+		);
+	}
+	fprintf(file, count > 0 ? "\n]\n" : "]\n");
+}
+
+// Benchmarks each algorithm on each network, starting with the automatic choice so that it can be compared with the rest,
+// and writes every result once they have all been found
+int run_benchmarks(String* file_names, int file_count, int thread_count, BenchmarkFormat format, String output_path) {
+	int algorithm_count = ALGORITHM_COUNT - ALGORITHM_AUTO; // The number of algorithms benchmarked on each network
+	BenchmarkResult* results = malloc((sizeof(BenchmarkResult)) * (file_count * algorithm_count + 1)); // The results found
+	int result_count = 0; // The number of results found
+	int file_total = 0; // The number of networks that were benchmarked
+	FILE* file = stdout; // The file to write the results to
+
+	for (int i = 0; i < file_count; i++) {
+		for (int algorithm = ALGORITHM_AUTO; algorithm < ALGORITHM_COUNT; algorithm++) {
+			if (!benchmark_routing(
+				file_names[i], algorithm, thread_count, BENCHMARK_WARMUP_RUNS, BENCHMARK_TRIAL_RUNS, &results[result_count]
+			)) {
+				break;
+			}
+			result_count++;
+
+			if (algorithm == ALGORITHM_COUNT - 1) {
+				file_total++;
+			}
+		}
+	}
+
+	if (output_path != NULL) {
+		file = fopen(output_path, "w");
+		if (file == NULL) {
+			printf("Error opening file!\n");
+			free(results);
+			return file_total;
+		}
+	}
+
+	write_benchmark_results(file, results, result_count, format);
+
+	if (file != stdout) {
+		fclose(file);
+	}
+	free(results);
+
+	return file_total;
+}
+
+// Writes each generated network to its own file, benchmarks the files together and then removes them
+int run_generated_benchmarks(
+	TopologyShape shape,
+	int* device_counts,
+	int count,
+	double average_degree,
+	uint64_t seed,
+	int thread_count,
+	BenchmarkFormat format,
+	String output_path
+) {
+	const String FILE_NAME_TEMPLATE = "generated_%s_devices_%d_avgdegree_%.1f_network.txt"; // The template of each file name
+	const int FILE_NAME_LENGTH = 100; // The most characters that each file name can take
+	char* names = malloc((size_t)FILE_NAME_LENGTH * (count > 0 ? count : 1)); // The name of each file, one after another
+	String* file_names = malloc((sizeof(String)) * (count > 0 ? count : 1)); // The start of the name of each written file
+	int file_count = 0; // The number of files written
+	int file_total; // The number of networks that were benchmarked
+
+	for (int i = 0; i < count; i++) {
+		file_names[file_count] = &names[i * FILE_NAME_LENGTH];
+		snprintf(file_names[file_count], FILE_NAME_LENGTH, FILE_NAME_TEMPLATE, get_topology_name(shape), device_counts[i], average_degree);
+
+		if (save_generated_network(shape, device_counts[i], average_degree, seed, file_names[file_count])) {
+			file_count++;
+		}
+	}
+
+	file_total = run_benchmarks(file_names, file_count, thread_count, format, output_path);
+
+	for (int i = 0; i < file_count; i++) {
+		remove(file_names[i]);
+	}
+	free(names);
+	free(file_names);
+
+	return file_total;
+}
+
+void test_benchmark() {
+	const String TEST_FILE_PATH = "test_graph.txt"; // The path of the file containing the test network
+	uint64_t timings[] = { 50, 10, 40, 20, 30 }; // Timings to find percentiles of, out of order
+	uint64_t earlier; // A time read from the clock before another
+	uint64_t later; // A time read from the clock after another
+	BenchmarkResult result; // The result of benchmarking the test network
+	BenchmarkResult written_results[2]; // Results with known timings to write
+
+	printf("\n------------------------------------------------------\n                 *benchmark.c tests*\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 1 - Test get_monotonic_nanoseconds()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n1. get_monotonic_nanoseconds() test\n----------------\n");
+
+	// 1.1 - Test reading the clock twice. The second time should never be earlier
+	earlier = get_monotonic_nanoseconds();
+	later = get_monotonic_nanoseconds();
+
+	printf("1.1 - Expected Result: not earlier\n1.1 - Actual Result: %s\n", later >= earlier ? "not earlier" : "earlier");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 2 - Test find_percentile()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n2. find_percentile() test\n----------------\n");
+
+	// 2.1 - Test the median, 95th percentile and lowest timing of five timings
+	printf("2.1 - Expected Result: 30 50 10\n2.1 - Actual Result: ");
+	printf(
+		"%llu %llu %llu\n",
+		(unsigned long long)find_percentile(timings, 5, 50),
+		(unsigned long long)find_percentile(timings, 5, 95),
+		(unsigned long long)find_percentile(timings, 5, 0)
+	);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 3 - Test benchmark_routing()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n3. benchmark_routing() test\n----------------\n");
+
+	// 3.1 - Test benchmarking the test network. The size of the network should be recorded, and the median should not be
+	//		 more than the 95th percentile or less than the fastest time
+	printf("3.1 - Expected Result: loaded, 5 devices, 8 links, 3 trials, median between fastest and p95\n");
+	printf("3.1 - Actual Result: %s, ", benchmark_routing(TEST_FILE_PATH, ALGORITHM_DIJKSTRA_HEAP, 1, 1, 3, &result) ? "loaded" : "not loaded");
+	printf(
+		"%d devices, %d links, %d trials, median %s\n",
+		result.vertices,
+		result.link_count,
+		result.trial_count,
+		result.build_fastest <= result.build_median && result.build_median <= result.build_p95 ? "between fastest and p95" : "out of order"
+	);
+
+	// 3.2 - Test benchmarking a file that does not exist
+	printf("3.2 - Expected Result: Error opening file!\n3.2 - Actual Result: ");
+	if (benchmark_routing("missing_network.txt", ALGORITHM_DIJKSTRA_HEAP, 1, 1, 3, &result)) {
+		printf("loaded\n");
+	}
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 4 - Test write_benchmark_results()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n4. write_benchmark_results() test\n----------------\n");
+
+	for (int i = 0; i < 2; i++) {
+		written_results[i].file_name = TEST_FILE_PATH;
+		written_results[i].algorithm = i == 0 ? ALGORITHM_DIJKSTRA_HEAP : ALGORITHM_SPFA;
+		written_results[i].thread_count = 1;
+		written_results[i].vertices = 5;
+		written_results[i].link_count = 8;
+		written_results[i].trial_count = 3;
+		written_results[i].load_median = 100;
+		written_results[i].load_p95 = 200;
+		written_results[i].build_median = 300 + i;
+		written_results[i].build_p95 = 400 + i;
+		written_results[i].build_fastest = 250 + i;
+	}
+
+	// 4.1 - Test writing two results as CSV
+	printf("4.1 - Expected Result:\n");
+	printf("file,algorithm,threads,devices,links,trials,load_median_ns,load_p95_ns,build_median_ns,build_p95_ns,build_fastest_ns\n");
+	printf("test_graph.txt,Dijkstra (heap),1,5,8,3,100,200,300,400,250\ntest_graph.txt,SPFA,1,5,8,3,100,200,301,401,251\n");
+	printf("4.1 - Actual Result:\n");
+	write_benchmark_results(stdout, written_results, 2, BENCHMARK_CSV);
+
+	// 4.2 - Test writing one result as JSON
+	printf("4.2 - Expected Result:\n[\n\t{\"file\": \"test_graph.txt\", \"algorithm\": \"SPFA\", \"threads\": 1, \"devices\": 5, ");
+	printf("\"links\": 8, \"trials\": 3, \"load_median_ns\": 100, \"load_p95_ns\": 200, \"build_median_ns\": 301, ");
+	printf("\"build_p95_ns\": 401, \"build_fastest_ns\": 251}\n]\n");
+	printf("4.2 - Actual Result:\n");
+	write_benchmark_results(stdout, &written_results[1], 1, BENCHMARK_JSON);
+}
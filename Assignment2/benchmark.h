@@ -0,0 +1,133 @@
+// benchmark.h
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "network.h"
+#include "topology.h"
+
+// The number of builds that are run and thrown away before each algorithm is timed, so that the caches and the memory
+// allocator are warmed up
+#define BENCHMARK_WARMUP_RUNS 1
+
+// The number of timed builds of each algorithm on each network
+#define BENCHMARK_TRIAL_RUNS 5
+
+typedef enum {
+	BENCHMARK_CSV = 0,	// One line of comma separated values for each algorithm and network, after a line of headings
+	BENCHMARK_JSON = 1	// An array with an object for each algorithm and network
+} BenchmarkFormat;
+
+/**
+ * @struct benchmarkResult
+ * @brief Represents the timings of building every routing table of one network with one algorithm
+ *
+ * Contains the file the network was loaded from, the algorithm (the one that was asked for, which may be ALGORITHM_AUTO),
+ * the number of threads used and the size of the network. Each trial loads the network again and then builds its routing
+ * tables, and the time taken by each step is kept separately. The median, 95th percentile and fastest time of each step
+ * are in nanoseconds, over trial_count trials.
+ */
+typedef struct benchmarkResult {
+	String file_name;
+	int algorithm;
+	int thread_count;
+	int vertices;
+	int link_count;
+	int trial_count;
+	uint64_t load_median;
+	uint64_t load_p95;
+	uint64_t build_median;
+	uint64_t build_p95;
+	uint64_t build_fastest;
+} BenchmarkResult;
+
+/**
+ * @brief Gets the time from a monotonic clock, which never goes backwards and is not changed by setting the system time
+ *
+ * @return The time in nanoseconds since an unspecified starting point
+ */
+uint64_t get_monotonic_nanoseconds();
+
+/**
+ * @brief Finds a percentile of some timings using the nearest rank, so the result is always one of the timings. The
+ *        timings are sorted in place
+ *
+ * @param timings The timings to find the percentile of
+ * @param count The number of timings, which must be at least 1
+ * @param percentile The percentile to find, from 0 to 100. 50 gives the median
+ *
+ * @return The timing at the percentile
+ */
+uint64_t find_percentile(uint64_t* timings, int count, int percentile);
+
+/**
+ * @brief Times building every routing table of a network with an algorithm. The network is loaded and built warmup_runs
+ *        times without being timed, then trial_runs times with the load and the build timed separately
+ *
+ * @param file_name The file to load the network from
+ * @param algorithm The algorithm to build the routing tables with (see RoutingAlgorithm)
+ * @param thread_count The number of threads to build with (see build_routing_tables_parallel())
+ * @param warmup_runs The number of untimed runs
+ * @param trial_runs The number of timed runs, which must be at least 1
+ * @param result Pointer to where the timings are stored
+ *
+ * @return Whether the network could be loaded
+ */
+bool benchmark_routing(String file_name, int algorithm, int thread_count, int warmup_runs, int trial_runs, BenchmarkResult* result);
+
+/**
+ * @brief Writes benchmark results to a file in a format that can be read by other programs
+ *
+ * @param file The file to write to, which can be stdout
+ * @param results The results to write
+ * @param count The number of results
+ * @param format The format to write them in
+ */
+void write_benchmark_results(FILE* file, BenchmarkResult* results, int count, BenchmarkFormat format);
+
+/**
+ * @brief Benchmarks every algorithm, and the automatic choice of one, on each of a list of networks, then writes the
+ *        results. Networks that cannot be loaded are skipped
+ *
+ * @param file_names The files to load the networks from
+ * @param file_count The number of files
+ * @param thread_count The number of threads to build with (see build_routing_tables_parallel())
+ * @param format The format to write the results in
+ * @param output_path The file to write the results to, or NULL to write them to stdout
+ *
+ * @return The number of networks that were benchmarked
+ */
+int run_benchmarks(String* file_names, int file_count, int thread_count, BenchmarkFormat format, String output_path);
+
+/**
+ * @brief Generates a network of each of a list of sizes and benchmarks every algorithm on them (see run_benchmarks()). Each
+ *        network is written to a file first, named after its shape and size, so that loading it is timed as well. The
+ *        files are removed afterwards
+ *
+ * @param shape The shape of the networks to generate
+ * @param device_counts The number of devices in each network
+ * @param count The number of networks
+ * @param average_degree The average number of links each device should have (see create_topology_generator())
+ * @param seed The seed of the random numbers
+ * @param thread_count The number of threads to build with (see build_routing_tables_parallel())
+ * @param format The format to write the results in
+ * @param output_path The file to write the results to, or NULL to write them to stdout
+ *
+ * @return The number of networks that were benchmarked
+ */
+int run_generated_benchmarks(
+	TopologyShape shape,
+	int* device_counts,
+	int count,
+	double average_degree,
+	uint64_t seed,
+	int thread_count,
+	BenchmarkFormat format,
+	String output_path
+);
+
+/**
+ * @brief Tests all of the functions within this file
+ */
+void test_benchmark();
@@ -0,0 +1,586 @@
+// contraction.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdbool.h>
+
+#include "network.h"
+#include "priority_queue.h"
+#include "contraction.h"
+
+
+// Adds a link from one device to another in the graph, or makes the existing link between them faster if the new one is
+// faster. Only adds the link in one direction
+void add_contraction_link(ContractionGraph* self, int from_device, int to_device, int speed, int middle_device) {
+	ContractionLink* links = self->links[from_device]; // The links of the device the link comes from
+
+	for (int i = 0; i < self->link_counts[from_device]; i++) {
+		if (links[i].to_device == to_device) {
+			if (speed < links[i].speed) {
+				links[i].speed = speed;
+				links[i].middle_device = middle_device;
+			}
+			return;
+		}
+	}
+
+	if (self->link_counts[from_device] == self->link_capacities[from_device]) {
+		self->link_capacities[from_device] = self->link_capacities[from_device] * 2 + 4;
+		self->links[from_device] = realloc(
+			self->links[from_device], (sizeof(ContractionLink)) * self->link_capacities[from_device]
+		);
+	}
+
+	self->links[from_device][self->link_counts[from_device]].to_device = to_device;
+	self->links[from_device][self->link_counts[from_device]].speed = speed;
+	self->links[from_device][self->link_counts[from_device]].middle_device = middle_device;
+	self->link_counts[from_device]++;
+}
+
+// Creates a graph for contraction from the packed links of a frozen network, dropping links from a device to itself. The
+// graph uses the external ids of the devices, so that the hierarchy does too
+ContractionGraph create_contraction_graph(Network* network) {
+	ContractionGraph new_graph; // The newly created graph
+	int device_id; // The external id of the current device
+
+	new_graph.vertices = network->vertices;
+	new_graph.links = malloc((sizeof(ContractionLink*)) * network->vertices);
+	new_graph.link_counts = malloc((sizeof(int)) * network->vertices);
+	new_graph.link_capacities = malloc((sizeof(int)) * network->vertices);
+	new_graph.contracted = malloc((sizeof(bool)) * network->vertices);
+	new_graph.contracted_neighbours = malloc((sizeof(int)) * network->vertices);
+
+	for (int i = 0; i < network->vertices; i++) {
+		device_id = to_external_id(network, i);
+		new_graph.link_capacities[device_id] = network->link_offsets[i + 1] - network->link_offsets[i];
+		new_graph.links[device_id] = malloc((sizeof(ContractionLink)) * (new_graph.link_capacities[device_id] + 1));
+		new_graph.link_counts[device_id] = 0;
+		new_graph.contracted[device_id] = false;
+		new_graph.contracted_neighbours[device_id] = 0;
+	}
+
+	for (int i = 0; i < network->vertices; i++) {
+		for (int j = network->link_offsets[i]; j < network->link_offsets[i + 1]; j++) {
+			if (network->packed_links[j].to_device != i) {
+				add_contraction_link(
+					&new_graph,
+					to_external_id(network, i),
+					to_external_id(network, network->packed_links[j].to_device),
+					network->packed_links[j].speed,
+					-1
+				);
+			}
+		}
+	}
+
+	return new_graph;
+}
+
+// Frees the memory used by a graph for contraction
+void delete_contraction_graph(ContractionGraph* self) {
+	for (int i = 0; i < self->vertices; i++) {
+		free(self->links[i]);
+	}
+
+	free(self->links);
+	free(self->link_counts);
+	free(self->link_capacities);
+	free(self->contracted);
+	free(self->contracted_neighbours);
+}
+
+// Creates and returns the working memory for witness searches over a graph with the given number of devices
+WitnessSearch create_witness_search(int vertices) {
+	WitnessSearch new_search; // The newly created working memory
+
+	new_search.distances = malloc((sizeof(int)) * vertices);
+	new_search.heap = create_indexed_heap(vertices);
+	new_search.touched_devices = malloc((sizeof(int)) * vertices);
+	new_search.touched_count = 0;
+
+	for (int i = 0; i < vertices; i++) {
+		new_search.distances[i] = INT_MAX;
+	}
+
+	return new_search;
+}
+
+// Frees the working memory used for witness searches
+void delete_witness_search(WitnessSearch* self) {
+	free(self->distances);
+	free(self->touched_devices);
+	delete_indexed_heap(&self->heap);
+}
+
+// Finds the distances from a device to the devices around it without going through the device being contracted or any
+// device that has already been contracted. Stops once the closest waiting device is further than max_distance or once
+// WITNESS_SETTLE_LIMIT devices have been settled. The distances must be reset with reset_witness_search() afterwards
+void run_witness_search(ContractionGraph* graph, WitnessSearch* self, int source_device, int avoided_device, int max_distance) {
+	int settled = 0; // The number of devices settled so far
+	int current_device; // The currently assessed device
+	ContractionLink* current_link;
+
+	self->distances[source_device] = 0;
+	self->touched_devices[0] = source_device;
+	self->touched_count = 1;
+	heap_push_or_decrease(&self->heap, source_device, 0);
+
+	while (!heap_is_empty(&self->heap) && self->heap.entries[0].priority <= max_distance && settled < WITNESS_SETTLE_LIMIT) {
+		current_device = heap_pop_min(&self->heap).device;
+		settled++;
+
+		for (int i = 0; i < graph->link_counts[current_device]; i++) {
+			current_link = &graph->links[current_device][i];
+
+			if (current_link->to_device == avoided_device || graph->contracted[current_link->to_device]) {
+				continue;
+			}
+
+			if (self->distances[current_device] + current_link->speed < self->distances[current_link->to_device]) {
+				if (self->distances[current_link->to_device] == INT_MAX) {
+					self->touched_devices[self->touched_count] = current_link->to_device;
+					self->touched_count++;
+				}
+
+				self->distances[current_link->to_device] = self->distances[current_device] + current_link->speed;
+				heap_push_or_decrease(&self->heap, current_link->to_device, self->distances[current_link->to_device]);
+			}
+		}
+	}
+
+	heap_clear(&self->heap);
+}
+
+// Resets the distances of every device that the last witness search touched
+void reset_witness_search(WitnessSearch* self) {
+	for (int i = 0; i < self->touched_count; i++) {
+		self->distances[self->touched_devices[i]] = INT_MAX;
+	}
+
+	self->touched_count = 0;
+}
+
+// Counts the shortcuts that contracting a device needs between its neighbours that have not been contracted, and adds
+// them to the graph if add_shortcuts is set. Returns the number of shortcuts
+int find_shortcuts(ContractionGraph* graph, WitnessSearch* witness, int device_index, bool add_shortcuts) {
+	ContractionLink* links = graph->links[device_index]; // The links of the device being contracted
+	int link_count = graph->link_counts[device_index]; // The number of links the device has
+	int shortcut_count = 0; // The number of shortcuts needed
+	int longest_link = 0; // The slowest link to a neighbour that has not been contracted
+	int via_distance; // The cost of going between two neighbours through the device
+
+	for (int i = 0; i < link_count; i++) {
+		if (!graph->contracted[links[i].to_device] && links[i].speed > longest_link) {
+			longest_link = links[i].speed;
+		}
+	}
+
+	// Each pair of neighbours is checked once, from the neighbour that comes first in the device's links
+	for (int i = 0; i < link_count; i++) {
+		if (graph->contracted[links[i].to_device]) {
+			continue;
+		}
+
+		run_witness_search(graph, witness, links[i].to_device, device_index, links[i].speed + longest_link);
+
+		for (int j = i + 1; j < link_count; j++) {
+			if (graph->contracted[links[j].to_device]) {
+				continue;
+			}
+
+			via_distance = links[i].speed + links[j].speed;
+			if (witness->distances[links[j].to_device] > via_distance) {
+				shortcut_count++;
+
+				if (add_shortcuts) {
+					add_contraction_link(graph, links[i].to_device, links[j].to_device, via_distance, device_index);
+					add_contraction_link(graph, links[j].to_device, links[i].to_device, via_distance, device_index);
+
+					// Adding links can move the device's own array, but only its neighbours' arrays grow here
+					links = graph->links[device_index];
+				}
+			}
+		}
+
+		reset_witness_search(witness);
+	}
+
+	return shortcut_count;
+}
+
+// Returns how important a device is, where less important devices are contracted first. This is the number of shortcuts
+// it needs minus the number of links it removes, plus the number of its neighbours that have been contracted so that
+// devices are contracted evenly across the network
+int find_contraction_priority(ContractionGraph* graph, WitnessSearch* witness, int device_index) {
+	int remaining_links = 0; // The number of links to neighbours that have not been contracted
+
+	for (int i = 0; i < graph->link_counts[device_index]; i++) {
+		if (!graph->contracted[graph->links[device_index][i].to_device]) {
+			remaining_links++;
+		}
+	}
+
+	return find_shortcuts(graph, witness, device_index, false) - remaining_links + graph->contracted_neighbours[device_index];
+}
+
+// Builds and returns a contraction hierarchy of a network
+ContractionHierarchy* build_contraction_hierarchy(Network* network) {
+	ContractionHierarchy* new_hierarchy = malloc(sizeof * new_hierarchy); // The new hierarchy
+	ContractionGraph graph; // The links between devices as they are contracted
+	WitnessSearch witness; // The working memory for witness searches
+	IndexedHeap order; // The devices that have not been contracted, by priority
+	int current_device; // The device being contracted
+	int priority; // The up to date priority of the device being contracted
+	int next_rank = 0; // The rank of the next device to be contracted
+	int next_index = 0; // The index in the upward links that the next link goes into
+
+	freeze_network(network);
+
+	graph = create_contraction_graph(network);
+	witness = create_witness_search(network->vertices);
+	order = create_indexed_heap(network->vertices);
+
+	new_hierarchy->vertices = network->vertices;
+	new_hierarchy->ranks = malloc((sizeof(int)) * network->vertices);
+	new_hierarchy->shortcut_count = 0;
+
+	for (int i = 0; i < network->vertices; i++) {
+		heap_push_or_decrease(&order, i, find_contraction_priority(&graph, &witness, i));
+	}
+
+	while (!heap_is_empty(&order)) {
+		current_device = heap_pop_min(&order).device;
+
+		// Priorities change as the devices around them are contracted. Rather than updating every neighbour after each
+		// contraction, the priority is checked when the device comes out of the heap, and it goes back in if it has risen
+		// above the next device's
+		priority = find_contraction_priority(&graph, &witness, current_device);
+		if (!heap_is_empty(&order) && priority > order.entries[0].priority) {
+			heap_push_or_decrease(&order, current_device, priority);
+			continue;
+		}
+
+		new_hierarchy->shortcut_count += find_shortcuts(&graph, &witness, current_device, true);
+		graph.contracted[current_device] = true;
+		new_hierarchy->ranks[current_device] = next_rank;
+		next_rank++;
+
+		for (int i = 0; i < graph.link_counts[current_device]; i++) {
+			graph.contracted_neighbours[graph.links[current_device][i].to_device]++;
+		}
+	}
+
+	// The upward links of each device are the links it still had to devices that were contracted after it
+	new_hierarchy->upward_offsets = malloc((sizeof(int)) * (network->vertices + 1));
+	new_hierarchy->upward_link_count = 0;
+	for (int i = 0; i < network->vertices; i++) {
+		new_hierarchy->upward_offsets[i] = new_hierarchy->upward_link_count;
+
+		for (int j = 0; j < graph.link_counts[i]; j++) {
+			if (new_hierarchy->ranks[graph.links[i][j].to_device] > new_hierarchy->ranks[i]) {
+				new_hierarchy->upward_link_count++;
+			}
+		}
+	}
+	new_hierarchy->upward_offsets[network->vertices] = new_hierarchy->upward_link_count;
+
+	new_hierarchy->upward_links = malloc((sizeof(ContractionLink)) * new_hierarchy->upward_link_count);
+	for (int i = 0; i < network->vertices; i++) {
+		for (int j = 0; j < graph.link_counts[i]; j++) {
+			if (new_hierarchy->ranks[graph.links[i][j].to_device] > new_hierarchy->ranks[i]) {
+				new_hierarchy->upward_links[next_index] = graph.links[i][j];
+				next_index++;
+			}
+		}
+	}
+
+	delete_contraction_graph(&graph);
+	delete_witness_search(&witness);
+	delete_indexed_heap(&order);
+
+	return new_hierarchy;
+}
+
+// Creates and returns the working memory needed to find routes with a contraction hierarchy
+ContractionQuery create_contraction_query(ContractionHierarchy* hierarchy) {
+	ContractionQuery new_query; // The newly created working memory
+
+	new_query.forward_distances = malloc((sizeof(int)) * hierarchy->vertices);
+	new_query.backward_distances = malloc((sizeof(int)) * hierarchy->vertices);
+	new_query.forward_previous = malloc((sizeof(int)) * hierarchy->vertices);
+	new_query.backward_previous = malloc((sizeof(int)) * hierarchy->vertices);
+	new_query.forward_heap = create_indexed_heap(hierarchy->vertices);
+	new_query.backward_heap = create_indexed_heap(hierarchy->vertices);
+
+	// A device can be touched once from each side
+	new_query.touched_devices = malloc((sizeof(int)) * 2 * hierarchy->vertices);
+	new_query.touched_count = 0;
+	new_query.settled_count = 0;
+
+	for (int i = 0; i < hierarchy->vertices; i++) {
+		new_query.forward_distances[i] = INT_MAX;
+		new_query.backward_distances[i] = INT_MAX;
+		new_query.forward_previous[i] = -1;
+		new_query.backward_previous[i] = -1;
+	}
+
+	return new_query;
+}
+
+// Returns the link of a contraction hierarchy between two devices, which is one of the upward links of the lower ranked
+// device. Returns NULL if there is no link between them
+ContractionLink* find_contraction_link(ContractionHierarchy* self, int first_device, int second_device) {
+	int lower_device = self->ranks[first_device] < self->ranks[second_device] ? first_device : second_device; // The lower ranked device
+	int higher_device = lower_device == first_device ? second_device : first_device; // The higher ranked device
+
+	for (int i = self->upward_offsets[lower_device]; i < self->upward_offsets[lower_device + 1]; i++) {
+		if (self->upward_links[i].to_device == higher_device) {
+			return &self->upward_links[i];
+		}
+	}
+
+	return NULL;
+}
+
+// Returns the first device of the network after from_device on the path that the link from from_device to to_device stands
+// for. A shortcut's path starts with the path to its middle device, so shortcuts are followed towards from_device until a
+// link of the network is reached
+int unpack_first_hop(ContractionHierarchy* self, int from_device, int to_device) {
+	ContractionLink* link = find_contraction_link(self, from_device, to_device); // The link being unpacked
+
+	while (link->middle_device != -1) {
+		to_device = link->middle_device;
+		link = find_contraction_link(self, from_device, to_device);
+	}
+
+	return to_device;
+}
+
+// Searches upwards from one end of a route for one step, and records the route through the settled device if the other
+// search has reached it and it is the shortest route so far
+void step_contraction_search(
+	ContractionHierarchy* self, ContractionQuery* query, bool forward, long long* best_cost, int* meeting_device
+) {
+	IndexedHeap* heap = forward ? &query->forward_heap : &query->backward_heap; // The heap of this search
+	int* distances = forward ? query->forward_distances : query->backward_distances; // The distances of this search
+	int* other_distances = forward ? query->backward_distances : query->forward_distances; // The distances of the other search
+	int* previous = forward ? query->forward_previous : query->backward_previous; // The previous devices of this search
+	int current_device = heap_pop_min(heap).device; // The device being settled
+	ContractionLink* current_link;
+
+	query->settled_count++;
+
+	if (other_distances[current_device] != INT_MAX && (long long)distances[current_device] + other_distances[current_device] < *best_cost) {
+		*best_cost = (long long)distances[current_device] + other_distances[current_device];
+		*meeting_device = current_device;
+	}
+
+	for (int i = self->upward_offsets[current_device]; i < self->upward_offsets[current_device + 1]; i++) {
+		current_link = &self->upward_links[i];
+
+		if (distances[current_device] + current_link->speed < distances[current_link->to_device]) {
+			if (distances[current_link->to_device] == INT_MAX) {
+				query->touched_devices[query->touched_count] = current_link->to_device;
+				query->touched_count++;
+			}
+
+			distances[current_link->to_device] = distances[current_device] + current_link->speed;
+			previous[current_link->to_device] = current_device;
+			heap_push_or_decrease(heap, current_link->to_device, distances[current_link->to_device]);
+		}
+	}
+}
+
+// Finds the route between two devices with an upward search from each of them
+Route find_route_contraction(ContractionHierarchy* self, int from_device, int to_device, ContractionQuery* query) {
+	Route route = { -1, -1 }; // The route that was found
+	long long best_cost = LLONG_MAX; // The cost of the shortest route found so far
+	int meeting_device = -1; // The highest ranked device of the shortest route found so far
+	bool forward_done; // Whether the forward search cannot find a shorter route
+	bool backward_done; // Whether the backward search cannot find a shorter route
+	int current_device; // The device being walked back over to find the first link of the route
+
+	query->settled_count = 0;
+	if (from_device == to_device) {
+		return route;
+	}
+
+	query->forward_distances[from_device] = 0;
+	query->backward_distances[to_device] = 0;
+	query->touched_devices[0] = from_device;
+	query->touched_devices[1] = to_device;
+	query->touched_count = 2;
+	heap_push_or_decrease(&query->forward_heap, from_device, 0);
+	heap_push_or_decrease(&query->backward_heap, to_device, 0);
+
+	// Each search goes on until its closest waiting device is no closer than the shortest route found
+	while (true) {
+		forward_done = heap_is_empty(&query->forward_heap) || query->forward_heap.entries[0].priority >= best_cost;
+		backward_done = heap_is_empty(&query->backward_heap) || query->backward_heap.entries[0].priority >= best_cost;
+
+		if (forward_done && backward_done) {
+			break;
+		}
+
+		step_contraction_search(
+			self,
+			query,
+			!forward_done && (backward_done || query->forward_heap.entries[0].priority <= query->backward_heap.entries[0].priority),
+			&best_cost,
+			&meeting_device
+		);
+	}
+
+	if (meeting_device != -1) {
+		route.cost = (int)best_cost;
+
+		// The route's first link goes from the first device to the device after it in the forward search, or to the device
+		// before it in the backward search if the searches met at the first device
+		if (meeting_device != from_device) {
+			current_device = meeting_device;
+			while (query->forward_previous[current_device] != from_device) {
+				current_device = query->forward_previous[current_device];
+			}
+		}
+		else {
+			current_device = query->backward_previous[from_device];
+		}
+
+		route.next_hop = unpack_first_hop(self, from_device, current_device);
+	}
+
+	// Reset every device that the searches touched
+	for (int i = 0; i < query->touched_count; i++) {
+		query->forward_distances[query->touched_devices[i]] = INT_MAX;
+		query->backward_distances[query->touched_devices[i]] = INT_MAX;
+		query->forward_previous[query->touched_devices[i]] = -1;
+		query->backward_previous[query->touched_devices[i]] = -1;
+	}
+	query->touched_count = 0;
+	heap_clear(&query->forward_heap);
+	heap_clear(&query->backward_heap);
+
+	return route;
+}
+
+// Frees the working memory used to find routes with a contraction hierarchy
+void delete_contraction_query(ContractionQuery* self) {
+	free(self->forward_distances);
+	free(self->backward_distances);
+	free(self->forward_previous);
+	free(self->backward_previous);
+	free(self->touched_devices);
+	delete_indexed_heap(&self->forward_heap);
+	delete_indexed_heap(&self->backward_heap);
+}
+
+// Frees the memory used by a contraction hierarchy
+void delete_contraction_hierarchy(ContractionHierarchy* self) {
+	free(self->ranks);
+	free(self->upward_offsets);
+	free(self->upward_links);
+	free(self);
+}
+
+void test_contraction() {
+	// Note about testing the helper functions: Every query relies on step_contraction_search, find_contraction_link and
+	// unpack_first_hop, and building a hierarchy relies on the graph, witness search and shortcut functions. The tests
+	// below check the routes against routing tables, so these do not need to be tested separately.
+
+	const String TEST_FILE_PATH = "test_graph.txt"; // The path of the file containing the test network
+	const String LARGE_FILE_PATH = "devices_500_avgdegree_5.0_large_network.txt"; // The path of a larger network
+	Network* testing_network = build_network_from_file(TEST_FILE_PATH); // The network used for testing this file
+	Network* large_network = build_network_from_file(LARGE_FILE_PATH); // A larger network to compare routes in
+	ContractionHierarchy* hierarchy; // The hierarchy of the network being tested
+	ContractionQuery query; // The working memory for the hierarchy being tested
+	Route route; // The most recently found route
+	int differences = 0; // The number of routes that differ from the routing tables
+	int current_device; // The device reached so far when following next hops
+
+	printf("\n------------------------------------------------------\n                *contraction.c tests*\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 1 - Test build_contraction_hierarchy()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n1. build_contraction_hierarchy() test\n----------------\n");
+
+	// 1.1 - Test that every upward link goes to a higher ranked device
+	hierarchy = build_contraction_hierarchy(testing_network);
+
+	printf("1.1 - Expected Result: 0 links go down\n1.1 - Actual Result: ");
+	for (int i = 0; i < hierarchy->vertices; i++) {
+		for (int j = hierarchy->upward_offsets[i]; j < hierarchy->upward_offsets[i + 1]; j++) {
+			if (hierarchy->ranks[hierarchy->upward_links[j].to_device] < hierarchy->ranks[i]) {
+				differences++;
+			}
+		}
+	}
+	printf("%d links go down\n", differences);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 2 - Test find_route_contraction()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n2. find_route_contraction() test\n----------------\n");
+
+	// 2.1 - Test a route that goes through several devices
+	query = create_contraction_query(hierarchy);
+	route = find_route_contraction(hierarchy, 0, 1, &query);
+
+	printf("2.1 - Expected Result: cost 6, next hop 3\n2.1 - Actual Result: ");
+	printf("cost %d, next hop %d\n", route.cost, route.next_hop);
+
+	// 2.2 - Test a route from a device to itself
+	route = find_route_contraction(hierarchy, 2, 2, &query);
+
+	printf("2.2 - Expected Result: cost -1, next hop -1\n2.2 - Actual Result: ");
+	printf("cost %d, next hop %d\n", route.cost, route.next_hop);
+
+	// 2.3 - Test a route between devices that are not connected
+	delete_contraction_query(&query);
+	delete_contraction_hierarchy(hierarchy);
+	delete_network(testing_network);
+	testing_network = create_network(3);
+	add_link(testing_network, 0, 1, 2);
+	hierarchy = build_contraction_hierarchy(testing_network);
+	query = create_contraction_query(hierarchy);
+	route = find_route_contraction(hierarchy, 0, 2, &query);
+
+	printf("2.3 - Expected Result: cost -1, next hop -1\n2.3 - Actual Result: ");
+	printf("cost %d, next hop %d\n", route.cost, route.next_hop);
+
+	// 2.4 - Test every route of a larger network against its routing tables. Following the next hops of each route
+	//		 should reach the device it goes to, which checks that shortcuts are unpacked into links of the network
+	delete_contraction_query(&query);
+	delete_contraction_hierarchy(hierarchy);
+	hierarchy = build_contraction_hierarchy(large_network);
+	query = create_contraction_query(hierarchy);
+	build_routing_tables(large_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	differences = 0;
+	for (int i = 0; i < large_network->vertices; i++) {
+		for (int j = 0; j < large_network->vertices; j++) {
+			route = find_route_contraction(hierarchy, i, j, &query);
+
+			if (route.cost != get_route_cost(large_network, i, j)) {
+				differences++;
+				continue;
+			}
+
+			current_device = i;
+			for (int k = 0; k < large_network->vertices && current_device != j && current_device != -1; k++) {
+				current_device = find_route_contraction(hierarchy, current_device, j, &query).next_hop;
+			}
+			if (route.cost != -1 && current_device != j) {
+				differences++;
+			}
+		}
+	}
+
+	printf("2.4 - Expected Result: 0 routes differ\n2.4 - Actual Result: %d routes differ\n", differences);
+
+	// Free memory
+	delete_contraction_query(&query);
+	delete_contraction_hierarchy(hierarchy);
+	delete_network(testing_network);
+	delete_network(large_network);
+}
@@ -0,0 +1,146 @@
+// contraction.h
+#pragma once
+
+#include "network.h"
+#include "priority_queue.h"
+
+// The most devices a witness search can settle before giving up. A witness search looks for a path that makes a shortcut
+// unnecessary, so giving up early only adds a shortcut that was not needed
+#define WITNESS_SETTLE_LIMIT 64
+
+/**
+ * @struct contractionLink
+ * @brief Represents a link in a contraction hierarchy, which is either a link of the network or a shortcut
+ *
+ * Contains the index of the device the link goes to, the speed of the link and the device that a shortcut skips over. A
+ * shortcut stands for the link to the middle device followed by the link from it, so its speed is theirs added together.
+ * The middle device is -1 for links of the network.
+ */
+typedef struct contractionLink {
+	int to_device;
+	int speed;
+	int middle_device;
+} ContractionLink;
+
+/**
+ * @struct contractionHierarchy
+ * @brief Represents a network whose devices have been contracted one at a time, in order of importance
+ *
+ * Contains the number of devices, the rank of each device (the order it was contracted in, so more important devices
+ * have higher ranks) and the upward links of each device in compressed sparse row form. The upward links of device i are
+ * upward_links[upward_offsets[i]] up to (not including) upward_links[upward_offsets[i + 1]], and each goes to a device
+ * with a higher rank. Every shortest path can be made of upward links from each end that meet at its highest ranked
+ * device, so a query only searches upwards from both ends. Also contains the number of shortcuts that were added.
+ */
+typedef struct contractionHierarchy {
+	int vertices;
+	int* ranks;
+	int* upward_offsets;
+	ContractionLink* upward_links;
+	int upward_link_count;
+	int shortcut_count;
+} ContractionHierarchy;
+
+/**
+ * @struct contractionGraph
+ * @brief Represents the links between devices while a contraction hierarchy is being built
+ *
+ * Contains a growable array of links for each device, with the number of links and the room each array has, whether each
+ * device has been contracted, and how many of each device's neighbours have been contracted. Each device has at most one
+ * link to each other device, which is the fastest one.
+ */
+typedef struct contractionGraph {
+	int vertices;
+	ContractionLink** links;
+	int* link_counts;
+	int* link_capacities;
+	bool* contracted;
+	int* contracted_neighbours;
+} ContractionGraph;
+
+/**
+ * @struct witnessSearch
+ * @brief Represents the working memory used to search for paths that avoid the device being contracted
+ *
+ * Contains the distance to each device, a heap of the reached devices whose distance is not final and a list of the
+ * devices whose distances have been set so that only those are reset after each search.
+ */
+typedef struct witnessSearch {
+	int* distances;
+	IndexedHeap heap;
+	int* touched_devices;
+	int touched_count;
+} WitnessSearch;
+
+/**
+ * @struct contractionQuery
+ * @brief Represents the working memory used to find routes with a contraction hierarchy
+ *
+ * Contains the distances and the previous device of each device reached by the upward search from each end of the route,
+ * a heap for each search, a list of the devices whose values have been set so that only those are reset after each query
+ * and the number of devices that the last query settled, counting both searches.
+ */
+typedef struct contractionQuery {
+	int* forward_distances;
+	int* backward_distances;
+	int* forward_previous;
+	int* backward_previous;
+	IndexedHeap forward_heap;
+	IndexedHeap backward_heap;
+	int* touched_devices;
+	int touched_count;
+	int settled_count;
+} ContractionQuery;
+
+/**
+ * @brief Builds a contraction hierarchy from a network. Devices are contracted in order of how many shortcuts they need
+ *        minus how many links they remove, plus how many of their neighbours have been contracted, and a shortcut is
+ *        added between two neighbours of a device when no path of at most the same cost avoids it. The network is frozen
+ *        first and is not changed. Assumes that the network has no negative weights
+ *
+ * @param network The network to build the hierarchy of
+ *
+ * @return Pointer to the new contraction hierarchy
+ */
+ContractionHierarchy* build_contraction_hierarchy(Network* network);
+
+/**
+ * @brief Creates the working memory needed to find routes with a contraction hierarchy
+ *
+ * @param hierarchy The hierarchy the working memory is for
+ *
+ * @return The new working memory
+ */
+ContractionQuery create_contraction_query(ContractionHierarchy* hierarchy);
+
+/**
+ * @brief Finds the route between two devices with an upward search from each of them, and unpacks the first link of the
+ *        route to find its next hop
+ *
+ * @param self The contraction hierarchy of the network the devices are in
+ * @param from_device The device the route starts at
+ * @param to_device The device the route goes to
+ * @param query Pointer to the working memory to use
+ *
+ * @return The route, with a next hop and cost of -1 if there is no route or the devices are the same
+ */
+Route find_route_contraction(ContractionHierarchy* self, int from_device, int to_device, ContractionQuery* query);
+
+/**
+ * @brief Frees the working memory used to find routes with a contraction hierarchy
+ *
+ * @param self Pointer to the working memory to delete
+ */
+void delete_contraction_query(ContractionQuery* self);
+
+/**
+ * @brief Frees the memory used by a contraction hierarchy
+ *
+ * @param self The contraction hierarchy to delete
+ */
+void delete_contraction_hierarchy(ContractionHierarchy* self);
+
+/**
+ * @brief Tests all of the functions within this file
+ */
+void test_contraction();
@@ -0,0 +1,472 @@
+// delta_stepping.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "network.h"
+#include "delta_stepping.h"
+
+// The state of a device that has not been reached, which is a distance of INT_MAX and a first hop of -1
+#define UNREACHED_STATE (((long long)INT_MAX << 32) | 0xFFFFFFFFLL)
+
+
+// Replaces a 64-bit value with another if it still holds the expected value, as one atomic step. Returns whether it was
+// replaced
+bool swap_if_unchanged_64(volatile long long* target, long long expected, long long replacement) {
+#ifdef _MSC_VER
+	return _InterlockedCompareExchange64(target, replacement, expected) == expected;
+#else
+	return __sync_bool_compare_and_swap(target, expected, replacement);
+#endif
+}
+
+// Replaces a 32-bit value with another if it still holds the expected value, as one atomic step. Returns whether it was
+// replaced
+bool swap_if_unchanged_32(volatile int* target, int expected, int replacement) {
+#ifdef _MSC_VER
+	return _InterlockedCompareExchange((volatile long*)target, replacement, expected) == expected;
+#else
+	return __sync_bool_compare_and_swap(target, expected, replacement);
+#endif
+}
+
+// Returns the number of the thread that calls it, which is 0 outside of a parallel region or without OpenMP
+int find_thread_number() {
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+// Adds a device to the end of a growable list, doubling its capacity when it is full
+void append_device(int** devices, int* size, int* capacity, int device_index) {
+	if (*size == *capacity) {
+		*capacity *= 2;
+		*devices = realloc(*devices, (sizeof(int)) * *capacity);
+	}
+
+	(*devices)[*size] = device_index;
+	(*size)++;
+}
+
+// Creates and returns the working memory needed to find the shortest paths from one device with several threads
+DeltaSteppingSearch create_delta_stepping_search(Network* network, int bucket_width, int thread_count) {
+	DeltaSteppingSearch new_search; // The newly created working memory
+	int slowest_speed = INT_MAX; // The speed of the slowest link, which is the smallest speed
+	int bin_total; // The number of bins over every thread
+
+	freeze_network(network);
+
+#ifdef _OPENMP
+	if (thread_count <= 0) {
+		thread_count = omp_get_max_threads();
+	}
+#else
+	thread_count = 1;
+#endif
+
+	if (bucket_width <= 0) {
+		for (int i = 0; i < network->link_count; i++) {
+			if (network->packed_links[i].speed < slowest_speed) {
+				slowest_speed = network->packed_links[i].speed;
+			}
+		}
+
+		bucket_width = slowest_speed == INT_MAX || slowest_speed < 1 ? DELTA_STEPPING_DEFAULT_WIDTH : DELTA_STEPPING_DEFAULT_WIDTH * slowest_speed;
+	}
+
+	new_search.vertices = network->vertices;
+	new_search.thread_count = thread_count;
+	new_search.bucket_width = bucket_width;
+
+	// A relaxed link puts a device at most max_speed past the current bucket's distances, so it is at most
+	// max_speed / bucket_width + 1 buckets ahead
+	new_search.bin_count = network->max_speed / bucket_width + 2;
+	bin_total = new_search.bin_count * thread_count;
+
+	new_search.states = malloc((sizeof(long long)) * (network->vertices > 0 ? network->vertices : 1));
+	new_search.settled_buckets = malloc((sizeof(int)) * (network->vertices > 0 ? network->vertices : 1));
+	new_search.bins = malloc((sizeof(int*)) * bin_total);
+	new_search.bin_sizes = malloc((sizeof(int)) * bin_total);
+	new_search.bin_capacities = malloc((sizeof(int)) * bin_total);
+	new_search.settled_devices = malloc((sizeof(int*)) * thread_count);
+	new_search.settled_sizes = malloc((sizeof(int)) * thread_count);
+	new_search.settled_capacities = malloc((sizeof(int)) * thread_count);
+	new_search.frontier_capacity = 16;
+	new_search.frontier = malloc((sizeof(int)) * new_search.frontier_capacity);
+	new_search.frontier_size = 0;
+	new_search.thread_sizes = malloc((sizeof(int)) * thread_count);
+	new_search.thread_offsets = malloc((sizeof(int)) * thread_count);
+	new_search.next_buckets = malloc((sizeof(long long)) * thread_count);
+	new_search.distances = malloc((sizeof(int)) * (network->vertices > 0 ? network->vertices : 1));
+	new_search.first_hops = malloc((sizeof(int)) * (network->vertices > 0 ? network->vertices : 1));
+
+	for (int i = 0; i < bin_total; i++) {
+		new_search.bin_capacities[i] = 16;
+		new_search.bin_sizes[i] = 0;
+		new_search.bins[i] = malloc((sizeof(int)) * new_search.bin_capacities[i]);
+	}
+	for (int i = 0; i < thread_count; i++) {
+		new_search.settled_capacities[i] = 16;
+		new_search.settled_sizes[i] = 0;
+		new_search.settled_devices[i] = malloc((sizeof(int)) * new_search.settled_capacities[i]);
+	}
+
+	return new_search;
+}
+
+// Relaxes a link from a device whose state was read as from_state. The new state replaces the state of the device the
+// link goes to if it is shorter, or as short with a lower first hop, and the device is then put into the bin of its new
+// bucket by the thread that changed it
+void relax_delta_stepping_link(
+	DeltaSteppingSearch* self, int thread, int source_device, int from_device, long long from_state, Link link
+) {
+	long long new_distance = (from_state >> 32) + link.speed; // The distance to the device through the link
+	int first_hop; // The first hop to the device through the link
+	long long new_state; // The state of the device through the link
+	long long old_state; // The state of the device before it is changed
+	int bin; // The bin the device is put into
+
+	if (new_distance >= INT_MAX || link.to_device == source_device) {
+		return;
+	}
+
+	// Devices linked to the source device are their own first hop, the rest share the first hop of the device before them
+	first_hop = from_device == source_device ? link.to_device : (int)(from_state & 0xFFFFFFFFLL);
+	new_state = (new_distance << 32) | (unsigned int)first_hop;
+
+	do {
+		old_state = self->states[link.to_device];
+		if (new_state >= old_state) {
+			return;
+		}
+	} while (!swap_if_unchanged_64(&self->states[link.to_device], old_state, new_state));
+
+	bin = thread * self->bin_count + (int)(new_distance / self->bucket_width % self->bin_count);
+	append_device(&self->bins[bin], &self->bin_sizes[bin], &self->bin_capacities[bin], link.to_device);
+}
+
+// Moves every thread's waiting devices for a bucket into the frontier. Must be called by every thread at once
+void gather_delta_stepping_bucket(DeltaSteppingSearch* self, int thread, long long bucket) {
+	int bin = thread * self->bin_count + (int)(bucket % self->bin_count); // The bin of this thread that holds the bucket
+
+	self->thread_sizes[thread] = self->bin_sizes[bin];
+#pragma omp barrier
+
+	// One thread works out where each thread's devices go, making the frontier bigger if they do not fit
+#pragma omp single
+	{
+		self->frontier_size = 0;
+		for (int i = 0; i < self->thread_count; i++) {
+			self->thread_offsets[i] = self->frontier_size;
+			self->frontier_size += self->thread_sizes[i];
+		}
+
+		if (self->frontier_size > self->frontier_capacity) {
+			while (self->frontier_size > self->frontier_capacity) {
+				self->frontier_capacity *= 2;
+			}
+			free(self->frontier);
+			self->frontier = malloc((sizeof(int)) * self->frontier_capacity);
+		}
+	}
+
+	memcpy(&self->frontier[self->thread_offsets[thread]], self->bins[bin], (sizeof(int)) * self->bin_sizes[bin]);
+	self->bin_sizes[bin] = 0;
+#pragma omp barrier
+}
+
+// Finds the shortest paths from one device to every other device with delta-stepping
+void find_shortest_paths_delta_stepping(Network* self, int device_index, DeltaSteppingSearch* search) {
+	long long current_bucket = 0; // The bucket whose devices are being settled, shared by every thread
+
+	freeze_network(self);
+
+#pragma omp parallel num_threads(search->thread_count)
+	{
+		int thread = find_thread_number(); // The number of this thread
+		int* settled_size = &search->settled_sizes[thread]; // The number of devices this thread settled in the bucket
+		int current_device; // The currently assessed device
+		long long current_state; // The state of the current device when it was taken from the frontier
+		long long bucket; // A bucket being checked for waiting devices
+
+#pragma omp for
+		for (int i = 0; i < search->vertices; i++) {
+			search->states[i] = UNREACHED_STATE;
+			search->settled_buckets[i] = -1;
+		}
+
+		// OpenMP can start fewer threads than were asked for, so the shares of any that did not start stay empty
+#pragma omp single
+		{
+			for (int i = 0; i < search->thread_count; i++) {
+				search->thread_sizes[i] = 0;
+				search->next_buckets[i] = -1;
+			}
+
+			search->states[device_index] = 0xFFFFFFFFLL;
+			search->frontier[0] = device_index;
+			search->frontier_size = 1;
+		}
+
+		while (search->frontier_size > 0) {
+			// Light phase. Relaxing light links can add devices to the current bucket, so repeat until it stays empty
+			while (search->frontier_size > 0) {
+#pragma omp for schedule(dynamic, DELTA_STEPPING_CHUNK_SIZE)
+				for (int i = 0; i < search->frontier_size; i++) {
+					current_device = search->frontier[i];
+					current_state = search->states[current_device];
+
+					// A device can be left in the bin of a bucket it has since been moved out of
+					if ((current_state >> 32) / search->bucket_width != current_bucket) {
+						continue;
+					}
+
+					// The first thread to settle a device in this bucket relaxes its heavy links later
+					if (
+						search->settled_buckets[current_device] != (int)current_bucket &&
+						swap_if_unchanged_32(
+							&search->settled_buckets[current_device], search->settled_buckets[current_device], (int)current_bucket
+						)
+					) {
+						append_device(
+							&search->settled_devices[thread], settled_size, &search->settled_capacities[thread], current_device
+						);
+					}
+
+					for (int j = self->link_offsets[current_device]; j < self->link_offsets[current_device + 1]; j++) {
+						if (self->packed_links[j].speed <= search->bucket_width) {
+							relax_delta_stepping_link(
+								search, thread, device_index, current_device, current_state, self->packed_links[j]
+							);
+						}
+					}
+				}
+
+				gather_delta_stepping_bucket(search, thread, current_bucket);
+			}
+
+			// Heavy phase. The devices settled in the bucket have their final distances now, so their heavy links are
+			// relaxed once, which can only add devices to later buckets
+			for (int i = 0; i < *settled_size; i++) {
+				current_device = search->settled_devices[thread][i];
+				current_state = search->states[current_device];
+
+				for (int j = self->link_offsets[current_device]; j < self->link_offsets[current_device + 1]; j++) {
+					if (self->packed_links[j].speed > search->bucket_width) {
+						relax_delta_stepping_link(search, thread, device_index, current_device, current_state, self->packed_links[j]);
+					}
+				}
+			}
+			*settled_size = 0;
+
+			// Every waiting device is less than bin_count buckets ahead, so the first bin of this thread with devices in
+			// it after the current bucket's holds its next bucket
+			search->next_buckets[thread] = -1;
+			for (bucket = current_bucket + 1; bucket < current_bucket + search->bin_count; bucket++) {
+				if (search->bin_sizes[thread * search->bin_count + (int)(bucket % search->bin_count)] > 0) {
+					search->next_buckets[thread] = bucket;
+					break;
+				}
+			}
+#pragma omp barrier
+
+#pragma omp single
+			{
+				bucket = -1;
+				for (int i = 0; i < search->thread_count; i++) {
+					if (search->next_buckets[i] != -1 && (bucket == -1 || search->next_buckets[i] < bucket)) {
+						bucket = search->next_buckets[i];
+					}
+				}
+
+				current_bucket = bucket;
+			}
+
+			// The search is finished once no thread has any waiting devices
+			if (current_bucket == -1) {
+				break;
+			}
+			gather_delta_stepping_bucket(search, thread, current_bucket);
+		}
+
+		// Unpack the distance and first hop of each device
+#pragma omp for
+		for (int i = 0; i < search->vertices; i++) {
+			search->distances[i] = i == device_index ? INT_MAX : (int)(search->states[i] >> 32);
+			search->first_hops[i] = (int)(search->states[i] & 0xFFFFFFFFLL);
+		}
+	}
+}
+
+// Frees the working memory used to find shortest paths with delta-stepping
+void delete_delta_stepping_search(DeltaSteppingSearch* self) {
+	for (int i = 0; i < self->bin_count * self->thread_count; i++) {
+		free(self->bins[i]);
+	}
+	for (int i = 0; i < self->thread_count; i++) {
+		free(self->settled_devices[i]);
+	}
+
+	free(self->states);
+	free(self->settled_buckets);
+	free(self->bins);
+	free(self->bin_sizes);
+	free(self->bin_capacities);
+	free(self->settled_devices);
+	free(self->settled_sizes);
+	free(self->settled_capacities);
+	free(self->frontier);
+	free(self->thread_sizes);
+	free(self->thread_offsets);
+	free(self->next_buckets);
+	free(self->distances);
+	free(self->first_hops);
+	self->states = NULL;
+	self->settled_buckets = NULL;
+	self->bins = NULL;
+	self->settled_devices = NULL;
+	self->frontier = NULL;
+	self->distances = NULL;
+	self->first_hops = NULL;
+}
+
+// Returns the number of devices whose distance or first hop from a source differs from the network's routing tables. A
+// first hop is only right if its link and the route from it add up to the cost in the table
+int count_delta_stepping_differences(Network* network, int source_device, DeltaSteppingSearch* search) {
+	int differences = 0; // The number of devices that differ
+	int cost; // The cost of the route to the current device in the routing table
+	int first_hop; // The first hop to the current device that was found
+	int fastest_speed; // The speed of the fastest link from the source to the first hop
+
+	for (int i = 0; i < network->vertices; i++) {
+		cost = get_route_cost(network, source_device, i);
+		first_hop = search->first_hops[i];
+
+		if ((cost == -1 ? INT_MAX : cost) != search->distances[i]) {
+			differences++;
+			continue;
+		}
+		if (cost == -1) {
+			continue;
+		}
+
+		fastest_speed = INT_MAX;
+		for (int j = network->link_offsets[source_device]; j < network->link_offsets[source_device + 1]; j++) {
+			if (network->packed_links[j].to_device == first_hop && network->packed_links[j].speed < fastest_speed) {
+				fastest_speed = network->packed_links[j].speed;
+			}
+		}
+
+		if (fastest_speed == INT_MAX || fastest_speed + (first_hop == i ? 0 : get_route_cost(network, first_hop, i)) != cost) {
+			differences++;
+		}
+	}
+
+	return differences;
+}
+
+void test_delta_stepping() {
+	// Note about testing relax_delta_stepping_link, gather_delta_stepping_bucket and the other helper functions: These are
+	// called by every search, so each of the tests below relies on them and they do not need to be tested separately. The
+	// same is true for create_delta_stepping_search.
+
+	const String TEST_FILE_PATH = "test_graph.txt"; // The path of the file containing the test network
+	const String LARGE_FILE_PATH = "devices_500_avgdegree_5.0_large_network.txt"; // The path of a larger network
+	Network* testing_network = build_network_from_file(TEST_FILE_PATH); // The network used for testing this file
+	Network* large_network = build_network_from_file(LARGE_FILE_PATH); // A larger network to check every route of
+	DeltaSteppingSearch search = create_delta_stepping_search(testing_network, 0, 2); // The working memory being tested
+	DeltaSteppingSearch other_search; // Working memory with a different number of threads
+	int bucket_widths[] = { 1, 0, 64 }; // The bucket widths to test the larger network with, where 0 is the default
+	int differences; // The number of routes that differ from the routing tables
+
+	printf("\n------------------------------------------------------\n               *delta_stepping.c tests*\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 1 - Test find_shortest_paths_delta_stepping()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n1. find_shortest_paths_delta_stepping() test\n----------------\n");
+
+	// 1.1 - Test the paths from device 0 of the test network with two threads. The default width is 4, so the link of
+	//		 speed 4 is light
+	find_shortest_paths_delta_stepping(testing_network, 0, &search);
+
+	printf("1.1 - Expected Result: costs 6 2 1 4, first hops 3 3 3 3\n1.1 - Actual Result: costs");
+	for (int i = 1; i < testing_network->vertices; i++) {
+		printf(" %d", search.distances[i]);
+	}
+	printf(", first hops");
+	for (int i = 1; i < testing_network->vertices; i++) {
+		printf(" %d", search.first_hops[i]);
+	}
+	printf("\n");
+
+	// 1.2 - Test a network with a link of speed 0 and a device with no links. The device should not be reached
+	delete_delta_stepping_search(&search);
+	delete_network(testing_network);
+	testing_network = create_network(4);
+	add_link(testing_network, 0, 1, 0);
+	add_link(testing_network, 1, 2, 3);
+	search = create_delta_stepping_search(testing_network, 0, 2);
+	find_shortest_paths_delta_stepping(testing_network, 0, &search);
+
+	printf("1.2 - Expected Result: device 2 cost 3 first hop 1, device 3 not reached\n1.2 - Actual Result: ");
+	printf(
+		"device 2 cost %d first hop %d, device 3 %s\n",
+		search.distances[2],
+		search.first_hops[2],
+		search.distances[3] == INT_MAX && search.first_hops[3] == -1 ? "not reached" : "reached"
+	);
+
+	// 1.3 - Test every source of a larger network with four threads and several bucket widths. Every distance should match
+	//		 the routing tables, and every first hop should start a route of that cost
+	build_routing_tables(large_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("1.3 - Expected Result: 0, 0 and 0 routes wrong\n1.3 - Actual Result: ");
+	for (int i = 0; i < 3; i++) {
+		delete_delta_stepping_search(&search);
+		search = create_delta_stepping_search(large_network, bucket_widths[i], 4);
+
+		differences = 0;
+		for (int j = 0; j < large_network->vertices; j++) {
+			find_shortest_paths_delta_stepping(large_network, j, &search);
+			differences += count_delta_stepping_differences(large_network, j, &search);
+		}
+
+		printf(i == 0 ? "%d" : i == 1 ? ", %d" : " and %d", differences);
+	}
+	printf(" routes wrong\n");
+
+	// 1.4 - Test that one thread and four threads find the same first hops, as ties are broken by the lower first hop
+	other_search = create_delta_stepping_search(large_network, 0, 1);
+	differences = 0;
+	for (int i = 0; i < large_network->vertices; i += 10) {
+		find_shortest_paths_delta_stepping(large_network, i, &search);
+		find_shortest_paths_delta_stepping(large_network, i, &other_search);
+
+		for (int j = 0; j < large_network->vertices; j++) {
+			if (search.first_hops[j] != other_search.first_hops[j]) {
+				differences++;
+			}
+		}
+	}
+
+	printf("1.4 - Expected Result: 0 first hops differ\n1.4 - Actual Result: %d first hops differ\n", differences);
+
+	// Free memory
+	delete_delta_stepping_search(&search);
+	delete_delta_stepping_search(&other_search);
+	delete_network(testing_network);
+	delete_network(large_network);
+}
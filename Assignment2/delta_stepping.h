@@ -0,0 +1,94 @@
+// delta_stepping.h
+#pragma once
+
+#include "network.h"
+
+// The number of frontier devices a thread takes at a time while relaxing links
+#define DELTA_STEPPING_CHUNK_SIZE 64
+
+// The bucket width used when none is given, as a multiple of the slowest link speed. With the usual speeds of 1, 2, 4 and
+// 8 this makes every link but the slowest class light
+#define DELTA_STEPPING_DEFAULT_WIDTH 4
+
+/**
+ * @struct deltaSteppingSearch
+ * @brief Represents the working memory used to find the shortest paths from one source device with several threads
+ *
+ * Contains the state of each device, which is its distance in the high 32 bits and the first hop to it in the low 32
+ * bits, so that both are changed together by one atomic compare and swap, and the bucket each device was last settled in.
+ * Also contains the width of each bucket and the number of buckets each thread keeps. Devices waiting in bucket b are kept
+ * by each thread in bin b % bin_count, as every waiting device is less than bin_count buckets ahead of the current one.
+ * The bins of thread t are bins[t * bin_count] up to (not including) bins[(t + 1) * bin_count], with their sizes and
+ * capacities. Each thread also keeps a list of the devices it settled in the current bucket, whose heavy links are relaxed
+ * once the bucket is empty.
+ *
+ * The frontier holds the devices of the current bucket, gathered from every thread's bin. thread_sizes and
+ * thread_offsets hold each thread's share of it, and next_buckets the next bucket each thread has waiting devices in.
+ *
+ * Once a search has finished, distances and first_hops hold the distance and first hop to each device by internal index,
+ * which are INT_MAX and -1 for devices that cannot be reached and for the source itself.
+ */
+typedef struct deltaSteppingSearch {
+	int vertices;
+	int thread_count;
+	int bucket_width;
+	int bin_count;
+	long long* states;
+	int* settled_buckets;
+	int** bins;
+	int* bin_sizes;
+	int* bin_capacities;
+	int** settled_devices;
+	int* settled_sizes;
+	int* settled_capacities;
+	int* frontier;
+	int frontier_size;
+	int frontier_capacity;
+	int* thread_sizes;
+	int* thread_offsets;
+	long long* next_buckets;
+	int* distances;
+	int* first_hops;
+} DeltaSteppingSearch;
+
+/**
+ * @brief Creates the working memory needed to find the shortest paths from one device of a network with several threads.
+ *        The network is frozen first
+ *
+ * @param network The network the working memory is for
+ * @param bucket_width The range of distances each bucket holds, or 0 to use DELTA_STEPPING_DEFAULT_WIDTH times the slowest
+ *                     link speed
+ * @param thread_count The number of threads to use, or 0 to use as many as OpenMP allows
+ *
+ * @return The new working memory
+ */
+DeltaSteppingSearch create_delta_stepping_search(Network* network, int bucket_width, int thread_count);
+
+/**
+ * @brief Finds the shortest paths from one device to every other device with delta-stepping. Devices wait in buckets that
+ *        each hold a range of distances of the bucket width, and every device in the closest bucket is handled at once
+ *        by all of the threads. Links no slower than the bucket width (light links) can put devices back into the same
+ *        bucket, so they are relaxed again and again until the bucket is empty. The slower (heavy) links of the devices
+ *        that were settled in it are then relaxed once. Each link is relaxed with an atomic compare and swap that keeps
+ *        the shorter distance, and the lower first hop when distances are equal, so the result does not depend on the
+ *        order the threads run in. The results are left in the working memory rather than stored in a routing table, as
+ *        this is meant for networks too large to have them. Assumes that the network has no negative weights and that
+ *        the network has not changed since the working memory was made
+ *
+ * @param self The network to search
+ * @param device_index The internal index of the device to search from
+ * @param search Pointer to the working memory to use, which holds the results afterwards
+ */
+void find_shortest_paths_delta_stepping(Network* self, int device_index, DeltaSteppingSearch* search);
+
+/**
+ * @brief Frees the working memory used to find shortest paths with delta-stepping
+ *
+ * @param self Pointer to the working memory to delete
+ */
+void delete_delta_stepping_search(DeltaSteppingSearch* self);
+
+/**
+ * @brief Tests all of the functions within this file
+ */
+void test_delta_stepping();
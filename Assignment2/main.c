@@ -1,9 +1,38 @@
 #include "network.h"
+#include "network_file.h"
+#include "priority_queue.h"
+#include "route_cache.h"
+#include "route_query.h"
+#include "contraction.h"
+#include "delta_stepping.h"
+#include "benchmark.h"
+#include "topology.h"
 
 int main() {
+	String benchmark_files[] = {
+		"devices_10_avgdegree_2.0_large_network.txt",
+		"devices_100_avgdegree_2.0_large_network.txt",
+		"devices_100_avgdegree_10.0_large_network.txt",
+		"devices_500_avgdegree_2.0_large_network.txt",
+		"devices_500_avgdegree_10.0_large_network.txt",
+		"devices_1000_avgdegree_2.3_large_network.txt",
+		"devices_1000_avgdegree_10.0_large_network.txt"
+	}; // The networks to benchmark each algorithm on
+	int generated_device_counts[] = { 500, 1000 }; // The sizes of the generated networks to benchmark each algorithm on
+
+	test_priority_queue();
 	test_network();
+	test_network_file();
+	test_route_cache();
+	test_route_query();
+	test_contraction();
+	test_delta_stepping();
+	test_benchmark();
+	test_topology();
 	printf("\n------------------------------------------------------\n                  *Algorithm Comparisons*\n");
 
-	compare_algorithms("devices_10000_avgdegree_2.3_large_network.txt");
+	run_benchmarks(benchmark_files, sizeof benchmark_files / sizeof * benchmark_files, 1, BENCHMARK_CSV, NULL);
+	run_generated_benchmarks(TOPOLOGY_GRID, generated_device_counts, 2, 4.0, 1, 1, BENCHMARK_CSV, NULL);
+	run_generated_benchmarks(TOPOLOGY_POWER_LAW, generated_device_counts, 2, 4.0, 1, 1, BENCHMARK_CSV, NULL);
 	return 0;
 }
\ No newline at end of file
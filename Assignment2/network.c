@@ -3,290 +3,2656 @@
 #include <math.h>
 #include <limits.h>
 #include <stdbool.h>
-#include <time.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Floyd-Warshall relaxes four costs at a time with SSE2, which every x64 processor has
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define FLOYD_WARSHALL_SSE2
+#endif
+
+// The cost Floyd-Warshall gives a pair of devices with no route, which is small enough to add to any cost without overflowing
+#define FLOYD_WARSHALL_NO_ROUTE (INT_MAX / 2)
+
+// The time each step of the routing algorithms takes in nanoseconds, measured on the sample networks and used to predict
+// which algorithm builds the routing tables the fastest. A step is a link relaxed, a device settled (per level of the heap
+// for the heap) or a cost relaxed in the Floyd-Warshall matrix
+#define COST_HEAP_LINK 5.4
+#define COST_HEAP_DEVICE 16.0
+#define COST_BUCKET_LINK 4.4
+#define COST_BUCKET_DEVICE 52.0
+#define COST_SPFA_STEP 10.0
+#define COST_FLOYD_WARSHALL_STEP 0.5
 
 #include "network.h"
+#include "network_file.h"
+#include "priority_queue.h"
+#include "route_cache.h"
+
+// The routing counters are only kept when ROUTING_COUNTERS is defined. Otherwise each count is left out when compiling, so
+// the routing algorithms do no extra work
+#ifdef ROUTING_COUNTERS
+#include "benchmark.h"
+#define COUNT_ROUTING(counters, counter, amount) ((counters).counter += (amount))
+#else
+#define COUNT_ROUTING(counters, counter, amount) ((void)0)
+#endif
+
+
+// Creates and returns a network with the given number of devices. Each device has no links and every route is unknown (-1)
+Network* create_network(int vertices) {
+	Network* new_network = malloc(sizeof(Network));   // The new network
+
+	new_network->vertices = vertices;
+	new_network->max_speed = 0;
+	new_network->link_offsets = NULL;
+	new_network->packed_links = NULL;
+	new_network->link_count = 0;
+	new_network->edges.from_devices = NULL;
+	new_network->edges.to_devices = NULL;
+	new_network->edges.speeds = NULL;
+	new_network->edges.count = 0;
+	new_network->packed_edges.edges = NULL;
+	new_network->packed_edges.class_count = 0;
+	new_network->pack_edges = false;
+	new_network->routing_plan.algorithm = ALGORITHM_AUTO;
+	new_network->routing_plan.predicted_cost = 0;
+	memset(&new_network->routing_counters, 0, sizeof new_network->routing_counters);
+	new_network->route_layout = ROUTES_PER_DEVICE;
+	new_network->route_slab.next_hops = NULL;
+	new_network->route_slab.costs = NULL;
+	new_network->route_slab.next_hop_bytes = 0;
+	new_network->route_slab.cost_bytes = 0;
+	new_network->routes_allocated = false;
+	new_network->mapped_file.data = NULL;
+	new_network->mapped_file.size = 0;
+	new_network->route_cache = NULL;
+	new_network->incremental_routing = false;
+	new_network->routes_current = false;
+	new_network->component_ids = NULL;
+	new_network->component_offsets = NULL;
+	new_network->component_devices = NULL;
+	new_network->component_count = 0;
+	new_network->external_ids = NULL;
+	new_network->internal_ids = NULL;
+
+	// Initilise each device and allocate memory. The routes are allocated when they are first needed
+	new_network->devices = malloc((sizeof * new_network->devices) * new_network->vertices);
+	for (int i = 0; i < new_network->vertices; i++)
+	{
+		new_network->devices[i].links.head = NULL;
+		new_network->devices[i].routes = NULL;
+	}
+
+	return new_network;
+}
+
+// Returns the number of bytes (1, 2 or 4) needed to store every value from 0 to largest_value, keeping the largest unsigned
+// value of the type free to stand for -1
+int choose_route_field_bytes(long long largest_value) {
+	if (largest_value < UCHAR_MAX) {
+		return 1;
+	}
+	if (largest_value < USHRT_MAX) {
+		return 2;
+	}
+
+	return 4;
+}
+
+// Reads one next hop or cost from a route slab array whose entries are the given number of bytes
+int read_route_field(void* fields, int bytes, size_t index) {
+	if (bytes == 1) {
+		return ((unsigned char*)fields)[index] == UCHAR_MAX ? -1 : ((unsigned char*)fields)[index];
+	}
+	if (bytes == 2) {
+		return ((unsigned short*)fields)[index] == USHRT_MAX ? -1 : ((unsigned short*)fields)[index];
+	}
+
+	return ((int*)fields)[index];
+}
+
+// Writes one next hop or cost into a route slab array whose entries are the given number of bytes. -1 is stored as the
+// largest unsigned value of the type
+void write_route_field(void* fields, int bytes, size_t index, int value) {
+	if (bytes == 1) {
+		((unsigned char*)fields)[index] = value == -1 ? UCHAR_MAX : (unsigned char)value;
+	}
+	else if (bytes == 2) {
+		((unsigned short*)fields)[index] = value == -1 ? USHRT_MAX : (unsigned short)value;
+	}
+	else {
+		((int*)fields)[index] = value;
+	}
+}
+
+// Finds an upper bound on the cost of any route in the network. A route between two devices in a group of connected
+// devices costs no more than going from one to the first device of the group and then on to the other, so no route can
+// cost more than twice the cost from that device to the device furthest from it. One heap Dijkstra is run from the
+// first device of each group, without resetting between groups, so this takes about as long as finding the routes from
+// a single device
+long long find_route_cost_bound(Network* self) {
+	int* distances = malloc((sizeof(int)) * self->vertices); // The cost from the first device of each group to each device
+	IndexedHeap unknown_devices = create_indexed_heap(self->vertices); // The reached devices whose distance is not yet final
+	long long bound = 0; // The largest bound found for any group
+	int furthest_distance; // The cost to the device furthest from the first device of the current group
+	int current_device; // The currently assessed device
+	Link* current_link;
+
+	freeze_network(self);
+
+	for (int i = 0; i < self->vertices; i++) {
+		distances[i] = INT_MAX;
+	}
+
+	for (int i = 0; i < self->vertices; i++) {
+		// Devices that have been reached already belong to an earlier group
+		if (distances[i] != INT_MAX) {
+			continue;
+		}
+
+		furthest_distance = 0;
+		distances[i] = 0;
+		heap_push_or_decrease(&unknown_devices, i, 0);
+
+		while (!heap_is_empty(&unknown_devices)) {
+			current_device = heap_pop_min(&unknown_devices).device;
+			furthest_distance = distances[current_device];
+
+			for (int j = self->link_offsets[current_device]; j < self->link_offsets[current_device + 1]; j++) {
+				current_link = &self->packed_links[j];
+
+				if (distances[current_device] + current_link->speed < distances[current_link->to_device]) {
+					distances[current_link->to_device] = distances[current_device] + current_link->speed;
+					heap_push_or_decrease(&unknown_devices, current_link->to_device, distances[current_link->to_device]);
+				}
+			}
+		}
+
+		if (2LL * furthest_distance > bound) {
+			bound = 2LL * furthest_distance;
+		}
+	}
+
+	delete_indexed_heap(&unknown_devices);
+	free(distances);
+
+	return bound;
+}
+
+// Returns the number of costs in the route slab for the given layout. The symmetric layout only stores the costs from each
+// device to the devices after it
+size_t count_route_slab_costs(Network* self, RouteLayout layout) {
+	if (layout == ROUTES_SYMMETRIC) {
+		return (size_t)self->vertices * (self->vertices - 1) / 2;
+	}
+
+	return (size_t)self->vertices * self->vertices;
+}
+
+// Returns the index in the route slab's costs of the route from one device to another. The devices must be different in
+// the symmetric layout
+size_t find_route_slab_cost_index(Network* self, int from_device, int to_device) {
+	size_t lower_device; // The device with the lower index, whose row the cost is in
+	size_t higher_device; // The device with the higher index
+
+	if (self->route_layout != ROUTES_SYMMETRIC) {
+		return (size_t)from_device * self->vertices + to_device;
+	}
+
+	lower_device = from_device < to_device ? from_device : to_device;
+	higher_device = from_device < to_device ? to_device : from_device;
+
+	// Row i starts after the V - 1 + V - 2 + ... + V - i costs of the rows before it
+	return lower_device * (2 * self->vertices - lower_device - 1) / 2 + (higher_device - lower_device - 1);
+}
+
+// Allocates the route slab for the given layout with every route unknown, using the narrowest types that can hold every
+// device index and every cost up to largest_cost
+void allocate_route_slab(Network* self, RouteLayout layout, long long largest_cost) {
+	size_t route_count = (size_t)self->vertices * self->vertices; // The number of next hops in the slab
+	size_t cost_count = count_route_slab_costs(self, layout); // The number of costs in the slab
+
+	self->route_slab.next_hop_bytes = choose_route_field_bytes(self->vertices - 1);
+	self->route_slab.cost_bytes = choose_route_field_bytes(largest_cost);
+
+	// Every byte being 0xFF is -1 for each of the widths
+	self->route_slab.next_hops = malloc(route_count * self->route_slab.next_hop_bytes);
+	self->route_slab.costs = malloc(cost_count * self->route_slab.cost_bytes);
+	memset(self->route_slab.next_hops, 0xFF, route_count * self->route_slab.next_hop_bytes);
+	memset(self->route_slab.costs, 0xFF, cost_count * self->route_slab.cost_bytes);
+}
+
+// Allocates an array of routes for each device with every route unknown
+void allocate_device_routes(Network* self) {
+	for (int i = 0; i < self->vertices; i++) {
+		self->devices[i].routes = malloc((sizeof * self->devices[i].routes) * self->vertices);
+		for (int j = 0; j < self->vertices; j++) {
+			self->devices[i].routes[j].next_hop = -1;
+			self->devices[i].routes[j].cost = -1;
+		}
+	}
+}
+
+// Frees the route slab, if the network has one
+void delete_route_slab(Network* self) {
+	free(self->route_slab.next_hops);
+	free(self->route_slab.costs);
+	self->route_slab.next_hops = NULL;
+	self->route_slab.costs = NULL;
+	self->route_slab.next_hop_bytes = 0;
+	self->route_slab.cost_bytes = 0;
+}
+
+// Frees the array of routes of each device, if they have them
+void delete_device_routes(Network* self) {
+	for (int i = 0; i < self->vertices; i++) {
+		free(self->devices[i].routes);
+		self->devices[i].routes = NULL;
+	}
+}
+
+// Allocates the routing tables in the network's route layout if they have not been allocated yet
+void allocate_routes(Network* self) {
+	if (self->routes_allocated) {
+		return;
+	}
+
+	if (self->route_layout != ROUTES_PER_DEVICE) {
+		allocate_route_slab(self, self->route_layout, find_route_cost_bound(self));
+	}
+	else {
+		allocate_device_routes(self);
+	}
+
+	self->routes_allocated = true;
+}
+
+// Makes the costs in the route slab wide enough to hold every cost up to largest_cost, keeping the costs already in it
+void widen_route_slab_costs(Network* self, long long largest_cost) {
+	size_t route_count = count_route_slab_costs(self, self->route_layout); // The number of costs in the slab
+	int new_bytes = choose_route_field_bytes(largest_cost); // The width that the costs need
+	void* new_costs; // The wider array of costs
+
+	if (new_bytes <= self->route_slab.cost_bytes) {
+		return;
+	}
+
+	new_costs = malloc(route_count * new_bytes);
+	for (size_t i = 0; i < route_count; i++) {
+		write_route_field(new_costs, new_bytes, i, read_route_field(self->route_slab.costs, self->route_slab.cost_bytes, i));
+	}
+
+	free(self->route_slab.costs);
+	self->route_slab.costs = new_costs;
+	self->route_slab.cost_bytes = new_bytes;
+}
+
+// Returns the internal index of the next hop of the route from one device to another, given by internal index, or -1 if
+// there is no route or no routes have been built
+int read_route_next_hop(Network* self, int from_device, int to_device) {
+	if (!self->routes_allocated) {
+		return -1;
+	}
+
+	if (self->route_layout != ROUTES_PER_DEVICE) {
+		return read_route_field(
+			self->route_slab.next_hops, self->route_slab.next_hop_bytes, (size_t)from_device * self->vertices + to_device
+		);
+	}
+
+	return self->devices[from_device].routes[to_device].next_hop;
+}
+
+// Returns the cost of the route from one device to another, given by internal index, or -1 if there is no route or no
+// routes have been built
+int read_route_cost(Network* self, int from_device, int to_device) {
+	if (!self->routes_allocated) {
+		return -1;
+	}
+
+	if (self->route_layout != ROUTES_PER_DEVICE) {
+		if (from_device == to_device && self->route_layout == ROUTES_SYMMETRIC) {
+			return -1;
+		}
+
+		return read_route_field(
+			self->route_slab.costs, self->route_slab.cost_bytes, find_route_slab_cost_index(self, from_device, to_device)
+		);
+	}
+
+	return self->devices[from_device].routes[to_device].cost;
+}
+
+// Stores the route from one device to another in whichever layout the network uses. The routes must be allocated. In the
+// symmetric layout this also sets the cost of the route back, and the cost from a device to itself is not stored
+void set_route(Network* self, int from_device, int to_device, int next_hop, int cost) {
+	size_t index = (size_t)from_device * self->vertices + to_device; // The index of the route's next hop in the route slab
+
+	if (self->route_layout != ROUTES_PER_DEVICE) {
+		write_route_field(self->route_slab.next_hops, self->route_slab.next_hop_bytes, index, next_hop);
+		if (from_device != to_device || self->route_layout != ROUTES_SYMMETRIC) {
+			write_route_field(
+				self->route_slab.costs, self->route_slab.cost_bytes, find_route_slab_cost_index(self, from_device, to_device), cost
+			);
+		}
+	}
+	else {
+		self->devices[from_device].routes[to_device].next_hop = next_hop;
+		self->devices[from_device].routes[to_device].cost = cost;
+	}
+}
+
+// Changes how the network stores its routing tables, copying any routes that have already been built into the new layout
+void set_route_layout(Network* self, RouteLayout layout) {
+	long long largest_cost; // The largest cost that the route slab has to hold
+
+	if (layout == self->route_layout) {
+		return;
+	}
+
+	if (!self->routes_allocated) {
+		self->route_layout = layout;
+		return;
+	}
+
+	// Move the routes out of the slab and into each device. Routes going from one slab layout to the other pass through here
+	if (self->route_layout != ROUTES_PER_DEVICE) {
+		allocate_device_routes(self);
+		for (int i = 0; i < self->vertices; i++) {
+			for (int j = 0; j < self->vertices; j++) {
+				self->devices[i].routes[j].next_hop = read_route_next_hop(self, i, j);
+				self->devices[i].routes[j].cost = read_route_cost(self, i, j);
+			}
+		}
+		self->route_layout = ROUTES_PER_DEVICE;
+		delete_route_slab(self);
+	}
+
+	if (layout != ROUTES_PER_DEVICE) {
+		// Routes built before links were changed can cost more than the current bound, so keep room for them too
+		largest_cost = find_route_cost_bound(self);
+		for (int i = 0; i < self->vertices; i++) {
+			for (int j = 0; j < self->vertices; j++) {
+				if (self->devices[i].routes[j].cost > largest_cost) {
+					largest_cost = self->devices[i].routes[j].cost;
+				}
+			}
+		}
+
+		allocate_route_slab(self, layout, largest_cost);
+		self->route_layout = layout;
+		for (int i = 0; i < self->vertices; i++) {
+			for (int j = 0; j < self->vertices; j++) {
+				set_route(self, i, j, self->devices[i].routes[j].next_hop, self->devices[i].routes[j].cost);
+			}
+		}
+		delete_device_routes(self);
+	}
+}
+
+// Returns the next hop of the route from one device to another, or -1 if there is no route or no routes have been built
+int get_route_next_hop(Network* self, int from_device, int to_device) {
+	return to_external_id(
+		self, read_route_next_hop(self, to_internal_id(self, from_device), to_internal_id(self, to_device))
+	);
+}
+
+// Returns the cost of the route from one device to another, or -1 if there is no route or no routes have been built
+int get_route_cost(Network* self, int from_device, int to_device) {
+	return read_route_cost(self, to_internal_id(self, from_device), to_internal_id(self, to_device));
+}
+
+// Returns the internal index of a device from its external id
+int to_internal_id(Network* self, int device_id) {
+	if (self->internal_ids == NULL || device_id == -1) {
+		return device_id;
+	}
+
+	return self->internal_ids[device_id];
+}
+
+// Returns the external id of a device from its internal index
+int to_external_id(Network* self, int device_index) {
+	if (self->external_ids == NULL || device_index == -1) {
+		return device_index;
+	}
+
+	return self->external_ids[device_index];
+}
+
+// Frees the component labels of a network, if it has them
+void delete_components(Network* self) {
+	free(self->component_ids);
+	free(self->component_offsets);
+	free(self->component_devices);
+	self->component_ids = NULL;
+	self->component_offsets = NULL;
+	self->component_devices = NULL;
+	self->component_count = 0;
+}
+
+// Returns the cost of the route from one device to another in the routing tables, which is 0 from a device to itself and
+// INT_MAX if there is no route
+int find_table_distance(Network* self, int from_device, int to_device) {
+	int cost; // The cost in the routing table
+
+	if (from_device == to_device) {
+		return 0;
+	}
+
+	cost = read_route_cost(self, from_device, to_device);
+	return cost == -1 ? INT_MAX : cost;
+}
+
+// Updates the routing tables after a link between two devices has been added or made faster, without searching the
+// network. Links go both ways, so every route that gets shorter is a route from its start to the first device, then the
+// link, then a route from the second device to its end, or that route backwards. Its start gets closer to the second device
+// through the link and its end gets closer to the first device through the link, so only the routes between those two sets
+// of devices can change. No device is in both sets, so none of the routes being read are written
+void repair_routes_after_faster_link(Network* self, int first_device, int second_device, int speed) {
+	int* sources; // The devices whose route to the second device gets shorter through the link
+	int* targets; // The devices whose route from the first device gets shorter through the link
+	int source_count = 0; // The number of sources
+	int target_count = 0; // The number of targets
+	long long furthest_source = 0; // The largest distance from a source to the first device
+	long long furthest_target = 0; // The largest distance from the second device to a target
+	int distance; // The distance currently being assessed
+	int source_hop; // The next hop from the current source towards the first device
+	long long cost; // The cost of the route from the current source to the current target through the link
+
+	if (first_device == second_device || find_table_distance(self, first_device, second_device) <= speed) {
+		return;
+	}
+
+	sources = malloc((sizeof(int)) * self->vertices);
+	targets = malloc((sizeof(int)) * self->vertices);
+
+	for (int i = 0; i < self->vertices; i++) {
+		distance = find_table_distance(self, i, first_device);
+		if (distance != INT_MAX && (long long)distance + speed < find_table_distance(self, i, second_device)) {
+			sources[source_count] = i;
+			source_count++;
+			if (distance > furthest_source) {
+				furthest_source = distance;
+			}
+		}
+
+		distance = find_table_distance(self, second_device, i);
+		if (distance != INT_MAX && (long long)distance + speed < find_table_distance(self, first_device, i)) {
+			targets[target_count] = i;
+			target_count++;
+			if (distance > furthest_target) {
+				furthest_target = distance;
+			}
+		}
+	}
+
+	// The link can join devices that could not reach each other before, so the new costs may not fit in the route slab
+	if (self->route_layout != ROUTES_PER_DEVICE) {
+		widen_route_slab_costs(self, furthest_source + speed + furthest_target);
+	}
+
+	for (int i = 0; i < source_count; i++) {
+		distance = find_table_distance(self, sources[i], first_device);
+		source_hop = sources[i] == first_device ? second_device : read_route_next_hop(self, sources[i], first_device);
+
+		for (int j = 0; j < target_count; j++) {
+			cost = (long long)distance + speed + find_table_distance(self, second_device, targets[j]);
+
+			// The route back from the target is the same route the other way, so it starts towards the second device
+			if (cost < find_table_distance(self, sources[i], targets[j])) {
+				set_route(self, sources[i], targets[j], source_hop, (int)cost);
+				set_route(
+					self,
+					targets[j],
+					sources[i],
+					targets[j] == second_device ? first_device : read_route_next_hop(self, targets[j], second_device),
+					(int)cost
+				);
+			}
+		}
+	}
+
+	free(sources);
+	free(targets);
+}
+
+// Adds a new link to a network. Assumes that the network has both the to and from nodes within it
+void add_link(Network* self, int first_device, int second_device, int speed) {
+	LinkNodePtr new_link_node; // The new link node
+	LinkNodePtr opposite_link_node; // The new link node to add to the second device
+
+	first_device = to_internal_id(self, first_device);
+	second_device = to_internal_id(self, second_device);
+
+	// Links can only be added to the linked lists
+	thaw_network(self);
+
+	// Cached shortest path trees may no longer be shortest
+	clear_route_cache(self);
+
+	// Create new node and assign values
+	new_link_node = malloc(sizeof * new_link_node);
+	new_link_node->link.to_device = second_device;
+	new_link_node->link.speed = speed;
+	new_link_node->next = self->devices[first_device].links.head;
+
+	// Add the link the other way
+	opposite_link_node = malloc(sizeof * opposite_link_node);
+	opposite_link_node->link.to_device = first_device;
+	opposite_link_node->link.speed = speed;
+	opposite_link_node->next = self->devices[second_device].links.head;
+
+
+	self->devices[first_device].links.head = new_link_node;
+	self->devices[second_device].links.head = opposite_link_node;
+
+	if (speed > self->max_speed) {
+		self->max_speed = speed;
+	}
+
+	// A link between two components joins them into one
+	if (self->component_ids != NULL && self->component_ids[first_device] != self->component_ids[second_device]) {
+		delete_components(self);
+	}
+
+	// Routing tables that were up to date are repaired in incremental mode, and are out of date otherwise
+	if (self->routes_current) {
+		if (self->incremental_routing) {
+			repair_routes_after_faster_link(self, first_device, second_device, speed);
+		}
+		else {
+			self->routes_current = false;
+		}
+	}
+}
+
+// Builds the edge list of a frozen network from its packed links if it has not been built yet
+void build_edge_list(Network* self) {
+	if (self->edges.from_devices != NULL) {
+		return;
+	}
+
+	self->edges.count = self->link_count;
+	self->edges.from_devices = malloc((sizeof(int)) * self->link_count);
+	self->edges.to_devices = malloc((sizeof(int)) * self->link_count);
+	self->edges.speeds = malloc((sizeof(int)) * self->link_count);
+
+	for (int i = 0; i < self->vertices; i++) {
+		for (int j = self->link_offsets[i]; j < self->link_offsets[i + 1]; j++) {
+			self->edges.from_devices[j] = i;
+			self->edges.to_devices[j] = self->packed_links[j].to_device;
+			self->edges.speeds[j] = self->packed_links[j].speed;
+		}
+	}
+}
+
+// Frees the edge list of a network, if it has one
+void delete_edge_list(Network* self) {
+	free(self->edges.from_devices);
+	free(self->edges.to_devices);
+	free(self->edges.speeds);
+	self->edges.from_devices = NULL;
+	self->edges.to_devices = NULL;
+	self->edges.speeds = NULL;
+	self->edges.count = 0;
+}
+
+// Packs the links of a frozen network into 32-bit words if it has not been done yet. Returns false, leaving the network
+// without packed edges, if the network has too many devices or too many different speeds to pack
+bool build_packed_edges(Network* self) {
+	PackedEdges* packed = &self->packed_edges; // The packed edges being built
+	int speed_class; // The speed class of the current link
+
+	if (packed->edges != NULL) {
+		return true;
+	}
+	if (self->vertices >= 1 << (32 - SPEED_CLASS_BITS)) {
+		return false;
+	}
+
+	// Give each different speed a class in the order they are first found
+	packed->class_count = 0;
+	for (int i = 0; i < self->link_count; i++) {
+		speed_class = 0;
+		while (speed_class < packed->class_count && packed->speeds[speed_class] != self->packed_links[i].speed) {
+			speed_class++;
+		}
+
+		if (speed_class == packed->class_count) {
+			if (packed->class_count == SPEED_CLASS_COUNT) {
+				packed->class_count = 0;
+				return false;
+			}
+
+			packed->speeds[speed_class] = self->packed_links[i].speed;
+			packed->class_count++;
+		}
+	}
+
+	packed->edges = malloc((sizeof(uint32_t)) * (self->link_count > 0 ? self->link_count : 1));
+	for (int i = 0; i < self->link_count; i++) {
+		speed_class = 0;
+		while (packed->speeds[speed_class] != self->packed_links[i].speed) {
+			speed_class++;
+		}
+
+		packed->edges[i] = ((uint32_t)self->packed_links[i].to_device << SPEED_CLASS_BITS) | (uint32_t)speed_class;
+	}
+
+	return true;
+}
+
+// Frees the packed edges of a network, if it has them
+void delete_packed_edges(Network* self) {
+	free(self->packed_edges.edges);
+	self->packed_edges.edges = NULL;
+	self->packed_edges.class_count = 0;
+}
+
+// Frees the packed link arrays of a frozen network, or unmaps the file they are in if the network was loaded from a binary
+// network file
+void release_packed_links(Network* self) {
+	if (self->mapped_file.data != NULL) {
+		unmap_network_file(&self->mapped_file);
+	}
+	else {
+		free(self->link_offsets);
+		free(self->packed_links);
+	}
+
+	self->link_offsets = NULL;
+	self->packed_links = NULL;
+}
+
+// Moves every link out of the devices' linked lists and into the packed link arrays, freeing the list nodes
+void freeze_network(Network* self) {
+	LinkNodePtr current_link; // The link node currently being packed
+	LinkNodePtr link_to_free; // The link node to free once it has been packed
+	int next_index = 0; // The index in the packed array that the next link goes into
+
+	if (self->link_offsets != NULL) {
+		return;
+	}
+
+	self->link_offsets = malloc((sizeof * self->link_offsets) * (self->vertices + 1));
+
+	// Count the links of each device to find where each device's links start in the packed array
+	self->link_count = 0;
+	for (int i = 0; i < self->vertices; i++) {
+		self->link_offsets[i] = self->link_count;
+
+		current_link = self->devices[i].links.head;
+		while (current_link != NULL) {
+			self->link_count++;
+			current_link = current_link->next;
+		}
+	}
+	self->link_offsets[self->vertices] = self->link_count;
+
+	// Pack the links in list order, freeing each node as it is copied
+	self->packed_links = malloc((sizeof * self->packed_links) * self->link_count);
+	for (int i = 0; i < self->vertices; i++) {
+		current_link = self->devices[i].links.head;
+		while (current_link != NULL) {
+			self->packed_links[next_index] = current_link->link;
+			next_index++;
+
+			link_to_free = current_link;
+			current_link = current_link->next;
+			free(link_to_free);
+		}
+
+		self->devices[i].links.head = NULL;
+	}
+}
+
+// Moves every link out of the packed link arrays and back into the devices' linked lists
+void thaw_network(Network* self) {
+	LinkNodePtr new_link_node; // The list node for the link currently being unpacked
+
+	if (self->link_offsets == NULL) {
+		return;
+	}
+
+	// Each link is added to the front of its list, so go through each device's links backwards to keep their order
+	for (int i = 0; i < self->vertices; i++) {
+		for (int j = self->link_offsets[i + 1] - 1; j >= self->link_offsets[i]; j--) {
+			new_link_node = malloc(sizeof * new_link_node);
+			new_link_node->link = self->packed_links[j];
+			new_link_node->next = self->devices[i].links.head;
+			self->devices[i].links.head = new_link_node;
+		}
+	}
+
+	release_packed_links(self);
+	self->link_count = 0;
+
+	delete_edge_list(self);
+	delete_packed_edges(self);
+}
+
+// Labels every device with its connected component, and groups the devices of each component together
+void label_components(Network* self) {
+	int* queue; // The devices found by the current search that have not had their links checked
+	int queue_start; // The position of the next device to check in the queue
+	int queue_end; // The position after the last device in the queue
+	int current_device; // The currently assessed device
+
+	freeze_network(self);
+	delete_components(self);
+
+	self->component_ids = malloc((sizeof(int)) * self->vertices);
+	queue = malloc((sizeof(int)) * self->vertices);
+	for (int i = 0; i < self->vertices; i++) {
+		self->component_ids[i] = -1;
+	}
+
+	// Each device that no earlier search reached starts a new component
+	for (int i = 0; i < self->vertices; i++) {
+		if (self->component_ids[i] != -1) {
+			continue;
+		}
+
+		self->component_ids[i] = self->component_count;
+		queue[0] = i;
+		queue_start = 0;
+		queue_end = 1;
+
+		while (queue_start < queue_end) {
+			current_device = queue[queue_start];
+			queue_start++;
+
+			for (int j = self->link_offsets[current_device]; j < self->link_offsets[current_device + 1]; j++) {
+				if (self->component_ids[self->packed_links[j].to_device] == -1) {
+					self->component_ids[self->packed_links[j].to_device] = self->component_count;
+					queue[queue_end] = self->packed_links[j].to_device;
+					queue_end++;
+				}
+			}
+		}
+
+		self->component_count++;
+	}
+
+	// Count the devices in each component to find where each component starts, then place the devices in order so that
+	// each component's devices stay in increasing order. The queue is reused for the next free slot of each component
+	self->component_offsets = calloc(self->component_count + 1, sizeof(int));
+	self->component_devices = malloc((sizeof(int)) * self->vertices);
+	for (int i = 0; i < self->vertices; i++) {
+		self->component_offsets[self->component_ids[i] + 1]++;
+	}
+	for (int i = 0; i < self->component_count; i++) {
+		self->component_offsets[i + 1] += self->component_offsets[i];
+		queue[i] = self->component_offsets[i];
+	}
+	for (int i = 0; i < self->vertices; i++) {
+		self->component_devices[queue[self->component_ids[i]]] = i;
+		queue[self->component_ids[i]]++;
+	}
+
+	free(queue);
+}
+
+// Compares two sort keys for qsort
+int compare_device_keys(const void* first, const void* second) {
+	long long first_key = *(const long long*)first; // The key of the first device
+	long long second_key = *(const long long*)second; // The key of the second device
+
+	return (first_key > second_key) - (first_key < second_key);
+}
+
+// Finds the order to renumber the devices of a frozen network in. Returns the current index of each device in its new
+// order, which must be freed. Devices are sorted by a key made of the value to sort by times the number of devices plus
+// the device's index, so devices with the same value stay in index order
+int* find_device_order(Network* self, DeviceOrder order) {
+	int* new_order = malloc((sizeof(int)) * self->vertices); // The current index of each device in its new order
+	long long* keys = malloc((sizeof(long long)) * (self->vertices > 0 ? self->vertices : 1)); // The keys being sorted
+	bool* visited = calloc(self->vertices > 0 ? self->vertices : 1, sizeof(bool)); // Whether each device has been ordered
+	long long* neighbour_keys; // The keys of the neighbours reached from the current device
+	int max_degree = 0; // The most links any device has
+	int queue_start = 0; // The position of the next device to check in the order
+	int queue_end = 0; // The position after the last device in the order
+	int link_count; // The number of links of the current device
+	int current_device; // The currently assessed device
+	int start_device; // The device that the current search starts from
+
+	for (int i = 0; i < self->vertices; i++) {
+		link_count = self->link_offsets[i + 1] - self->link_offsets[i];
+		if (link_count > max_degree) {
+			max_degree = link_count;
+		}
+	}
+
+	neighbour_keys = malloc((sizeof(long long)) * (max_degree + 1));
+
+	// Devices with more links come first, so sort by how many fewer links they have than the most
+	if (order == ORDER_DEGREE) {
+		for (int i = 0; i < self->vertices; i++) {
+			keys[i] = (long long)(max_degree - (self->link_offsets[i + 1] - self->link_offsets[i])) * self->vertices + i;
+		}
+		qsort(keys, self->vertices, sizeof * keys, compare_device_keys);
+		for (int i = 0; i < self->vertices; i++) {
+			new_order[i] = (int)(keys[i] % self->vertices);
+		}
+
+		free(keys);
+		free(neighbour_keys);
+		free(visited);
+		return new_order;
+	}
+
+	// Reverse Cuthill-McKee starts each search from the device with the fewest links that has not been reached yet, and a
+	// breadth first order starts from the lowest index
+	for (int i = 0; i < self->vertices; i++) {
+		keys[i] = order == ORDER_REVERSE_CUTHILL_MCKEE
+			? (long long)(self->link_offsets[i + 1] - self->link_offsets[i]) * self->vertices + i
+			: i;
+	}
+	qsort(keys, self->vertices, sizeof * keys, compare_device_keys);
+
+	// The new order is also the queue of each search, as devices are numbered in the order they are reached
+	for (int i = 0; i < self->vertices; i++) {
+		start_device = (int)(keys[i] % self->vertices);
+		if (visited[start_device]) {
+			continue;
+		}
+
+		visited[start_device] = true;
+		new_order[queue_end] = start_device;
+		queue_end++;
+
+		while (queue_start < queue_end) {
+			current_device = new_order[queue_start];
+			queue_start++;
+			link_count = 0;
+
+			for (int j = self->link_offsets[current_device]; j < self->link_offsets[current_device + 1]; j++) {
+				if (!visited[self->packed_links[j].to_device]) {
+					visited[self->packed_links[j].to_device] = true;
+					new_order[queue_end + link_count] = self->packed_links[j].to_device;
+					link_count++;
+				}
+			}
+
+			// Cuthill-McKee numbers the newly reached neighbours with fewer links first
+			if (order == ORDER_REVERSE_CUTHILL_MCKEE && link_count > 1) {
+				for (int j = 0; j < link_count; j++) {
+					current_device = new_order[queue_end + j];
+					neighbour_keys[j] =
+						(long long)(self->link_offsets[current_device + 1] - self->link_offsets[current_device]) * self->vertices +
+						current_device;
+				}
+				qsort(neighbour_keys, link_count, sizeof * neighbour_keys, compare_device_keys);
+				for (int j = 0; j < link_count; j++) {
+					new_order[queue_end + j] = (int)(neighbour_keys[j] % self->vertices);
+				}
+			}
+
+			queue_end += link_count;
+		}
+	}
+
+	// Reversing the Cuthill-McKee order puts each device after most of its neighbours
+	if (order == ORDER_REVERSE_CUTHILL_MCKEE) {
+		for (int i = 0; i < self->vertices / 2; i++) {
+			current_device = new_order[i];
+			new_order[i] = new_order[self->vertices - 1 - i];
+			new_order[self->vertices - 1 - i] = current_device;
+		}
+	}
+
+	free(keys);
+	free(neighbour_keys);
+	free(visited);
+	return new_order;
+}
+
+// Renumbers the devices of a network so that devices that are linked to each other are stored close together
+void reorder_devices(Network* self, DeviceOrder order) {
+	int* new_order; // The current index of each device in its new order
+	int* new_indexes; // The new index of each device, by its current index
+	int* new_offsets; // Where each device's links start in the renumbered packed array
+	Link* new_links; // The renumbered packed links
+	int* new_external_ids; // The external id of each device, by its new index
+	int link_index = 0; // The index in the renumbered packed array that the next link goes into
+
+	freeze_network(self);
+
+	new_order = find_device_order(self, order);
+	new_indexes = malloc((sizeof(int)) * self->vertices);
+	for (int i = 0; i < self->vertices; i++) {
+		new_indexes[new_order[i]] = i;
+	}
+
+	// Copy each device's links into its new place, changing where they go to the new indexes
+	new_offsets = malloc((sizeof(int)) * (self->vertices + 1));
+	new_links = malloc((sizeof(Link)) * (self->link_count > 0 ? self->link_count : 1));
+	for (int i = 0; i < self->vertices; i++) {
+		new_offsets[i] = link_index;
+		for (int j = self->link_offsets[new_order[i]]; j < self->link_offsets[new_order[i] + 1]; j++) {
+			new_links[link_index].to_device = new_indexes[self->packed_links[j].to_device];
+			new_links[link_index].speed = self->packed_links[j].speed;
+			link_index++;
+		}
+	}
+	new_offsets[self->vertices] = link_index;
+
+	// The packed links of a mapped file are released along with the file
+	release_packed_links(self);
+	self->link_offsets = new_offsets;
+	self->packed_links = new_links;
+
+	// The maps are combined with any earlier renumbering, so that they always lead back to the ids the devices were loaded with
+	new_external_ids = malloc((sizeof(int)) * self->vertices);
+	if (self->internal_ids == NULL) {
+		self->internal_ids = malloc((sizeof(int)) * self->vertices);
+	}
+	for (int i = 0; i < self->vertices; i++) {
+		new_external_ids[i] = to_external_id(self, new_order[i]);
+		self->internal_ids[new_external_ids[i]] = i;
+	}
+	free(self->external_ids);
+	self->external_ids = new_external_ids;
+
+	// Everything else that is stored by device index is dropped, to be rebuilt in the new order when it is next needed
+	if (self->routes_allocated) {
+		delete_route_slab(self);
+		delete_device_routes(self);
+		self->routes_allocated = false;
+	}
+	self->routes_current = false;
+	delete_edge_list(self);
+	delete_packed_edges(self);
+	clear_route_cache(self);
+	label_components(self);
+
+	free(new_order);
+	free(new_indexes);
+}
+
+// Reads the whole of a file into one buffer, which must be freed. Returns NULL if the file cannot be read
+char* read_whole_file(String filepath, size_t* length) {
+	FILE* file = fopen(filepath, "rb"); // The file to read from
+	char* contents; // The contents of the file
+	long file_size; // The size of the file in bytes
+
+	if (file == NULL) {
+		return NULL;
+	}
+
+	if (fseek(file, 0, SEEK_END) != 0 || (file_size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+		fclose(file);
+		return NULL;
+	}
+
+	contents = malloc((size_t)file_size + 1);
+	*length = fread(contents, 1, (size_t)file_size, file);
+	contents[*length] = '\0';
+	fclose(file);
+
+	return contents;
+}
+
+// Parses the next integer in a buffer, skipping the whitespace and commas before it, and moves the cursor past it. Returns
+// false if the buffer ends, something else comes before the next integer or the integer is too large for an int
+bool parse_next_int(char** cursor, char* end, int* value) {
+	char* current = *cursor; // The character being read
+	bool negative = false; // Whether the integer has a minus sign
+	int parsed = 0; // The value of the digits read so far
+	int digit; // The value of the digit being read
+
+	while (current < end && (*current == ',' || *current == ' ' || *current == '\t' || *current == '\r' || *current == '\n')) {
+		current++;
+	}
+
+	if (current < end && *current == '-') {
+		negative = true;
+		current++;
+	}
+
+	if (current == end || *current < '0' || *current > '9') {
+		return false;
+	}
+
+	while (current < end && *current >= '0' && *current <= '9') {
+		digit = *current - '0';
+		if (parsed > (INT_MAX - digit) / 10) {
+			return false;
+		}
+
+		parsed = parsed * 10 + digit;
+		current++;
+	}
+
+	*value = negative ? -parsed : parsed;
+	*cursor = current;
+
+	return true;
+}
+
+// Builds a frozen network from a list of links between pairs of devices, packing each link in both directions straight into
+// the link arrays instead of adding each one to the lists. Each device's links are packed in the same order that adding them
+// one at a time and then freezing would give
+Network* build_network_from_links(int vertices, int link_count, int* first_devices, int* second_devices, int* speeds) {
+	Network* new_network = create_network(vertices); // The new network
+	int* next_slots = malloc((sizeof(int)) * (vertices + 1)); // The packed index of each device's next link, counting down
+
+	new_network->link_count = 2 * link_count;
+	new_network->link_offsets = calloc((size_t)vertices + 1, sizeof * new_network->link_offsets);
+	new_network->packed_links = malloc((sizeof * new_network->packed_links) * (link_count > 0 ? 2 * (size_t)link_count : 1));
+
+	// Count the links of each device, shifted by one so that a running total gives where each device's links start
+	for (int i = 0; i < link_count; i++) {
+		new_network->link_offsets[first_devices[i] + 1]++;
+		new_network->link_offsets[second_devices[i] + 1]++;
+
+		if (speeds[i] > new_network->max_speed) {
+			new_network->max_speed = speeds[i];
+		}
+	}
+	for (int i = 0; i < vertices; i++) {
+		new_network->link_offsets[i + 1] += new_network->link_offsets[i];
+		next_slots[i] = new_network->link_offsets[i + 1] - 1;
+	}
+
+	// add_link puts each new link at the front of the list, so the last link in the list comes first. Filling each device's
+	// links from the back keeps that order
+	for (int i = 0; i < link_count; i++) {
+		new_network->packed_links[next_slots[first_devices[i]]].to_device = second_devices[i];
+		new_network->packed_links[next_slots[first_devices[i]]].speed = speeds[i];
+		next_slots[first_devices[i]]--;
+
+		new_network->packed_links[next_slots[second_devices[i]]].to_device = first_devices[i];
+		new_network->packed_links[next_slots[second_devices[i]]].speed = speeds[i];
+		next_slots[second_devices[i]]--;
+	}
+
+	free(next_slots);
+
+	label_components(new_network);
+
+	return new_network;
+}
+
+// Builds and returns network from given file. The whole file is read in one go and parsed by hand, then the parsed links
+// are handed to build_network_from_links, so no list nodes are made
+Network* build_network_from_file(String filepath) {
+	size_t length; // The number of characters in the file
+	char* contents = read_whole_file(filepath, &length); // The contents of the file
+	char* cursor; // The next character to parse
+	Network* new_network;	// The new network
+	int vertices;	   // The number of devices in the network
+	int file_links = 0; // The number of links in the file, each of which is packed in both directions
+	int* first_devices; // The first device of each link in the file
+	int* second_devices; // The second device of each link in the file
+	int* speeds; // The speed of each link in the file
+
+	// Stop function if file is not valid
+	if (contents == NULL) {
+		printf("Error opening file!\n");
+		return NULL;
+	}
+
+	cursor = contents;
+	if (!parse_next_int(&cursor, contents + length, &vertices) || vertices < 0) {
+		printf("Error: Not a network file!\n");
+		free(contents);
+		return NULL;
+	}
+
+	// There are at most as many links as there are groups of 3 integers in the rest of the file, and every integer has a
+	// character after it (or the end of the file)
+	first_devices = malloc((sizeof(int)) * (length / 6 + 1));
+	second_devices = malloc((sizeof(int)) * (length / 6 + 1));
+	speeds = malloc((sizeof(int)) * (length / 6 + 1));
+
+	while (
+		parse_next_int(&cursor, contents + length, &first_devices[file_links]) &&
+		parse_next_int(&cursor, contents + length, &second_devices[file_links]) &&
+		parse_next_int(&cursor, contents + length, &speeds[file_links])
+	) {
+		if (
+			first_devices[file_links] < 0 || first_devices[file_links] >= vertices ||
+			second_devices[file_links] < 0 || second_devices[file_links] >= vertices
+		) {
+			printf("Error: Link between devices that are not in the network!\n");
+			free(contents);
+			free(first_devices);
+			free(second_devices);
+			free(speeds);
+			return NULL;
+		}
+
+		file_links++;
+	}
+	free(contents);
+
+	new_network = build_network_from_links(vertices, file_links, first_devices, second_devices, speeds);
+
+	free(first_devices);
+	free(second_devices);
+	free(speeds);
+
+	return new_network;
+}
+
+// Checks whether all devices within the known array are known or not and returns the answer
+bool all_devices_known(bool* known_array, int length) {
+	bool all_known = true;
+
+	for (int i = 0; i < length; i++)
+	{
+		if (!known_array[i]) {
+			all_known = false;
+		}
+	}
+
+	return all_known;
+}
+
+// Builds a routing table from an array of distances between the source device and the destination device, and an array of
+// the first hop on the path from the source device to each destination device (-1 if the destination cannot be reached)
+void build_routing_table_from_first_hops(Network* self, int* first_hops, int* distances, int device_index) {
+	allocate_routes(self);
+
+	for (int i = 0; i < self->vertices; i++) {
+		if (i == device_index) {
+			continue;
+		}
+
+		// If device can be reached
+		if (first_hops[i] != -1) {
+			set_route(self, device_index, i, first_hops[i], distances[i]);
+		}
+		else {
+			set_route(self, device_index, i, -1, -1);
+		}
+	}
+}
+
+// Builds a routing table from an array of distances between the source device and the destination device, and an array of 
+// the previous hops of each of the destination devices. The first hop of each device is found once and then reused by every
+// device behind it on the same path, so each device is only walked over once rather than once per destination behind it
+void build_routing_table_from_distances(Network* self, int* previous, int* distances, int device_index) {
+	int* first_hops = malloc((sizeof(int)) * self->vertices); // The first hop to each device, -2 if not found yet
+	int* path = malloc((sizeof(int)) * self->vertices); // The devices walked over since the last device with a known first hop
+	int path_length; // The number of devices in the path
+	int current_device; // The currently assessed device
+	int first_hop; // The first hop found for every device in the path
+
+	for (int i = 0; i < self->vertices; i++) {
+		first_hops[i] = -2;
+	}
+	first_hops[device_index] = -1;
+
+	for (int i = 0; i < self->vertices; i++) {
+		current_device = i;
+		path_length = 0;
+
+		// Backtrack until reaching a device whose first hop is known, or just before the parameter device. -1 check is
+		// necessary to see if device is unreachable. The length check stops a broken chain of previous hops looping forever
+		while (
+			first_hops[current_device] == -2 && previous[current_device] != device_index && 
+			previous[current_device] != -1 && path_length < self->vertices
+		) {
+			path[path_length] = current_device;
+			path_length++;
+			current_device = previous[current_device];
+		}
+
+		if (first_hops[current_device] != -2) {
+			first_hop = first_hops[current_device];
+		}
+		else if (previous[current_device] == device_index) {
+			first_hop = current_device;
+		}
+		else { // If there is no valid path
+			first_hop = -1;
+		}
+
+		// Every device on the path shares the same first hop
+		first_hops[current_device] = first_hop;
+		for (int j = 0; j < path_length; j++) {
+			first_hops[path[j]] = first_hop;
+		}
+
+		if (first_hop != -1) {
+			COUNT_ROUTING(self->routing_counters, routes_stored, 1);
+		}
+	}
+
+	build_routing_table_from_first_hops(self, first_hops, distances, device_index);
+
+	free(first_hops);
+	free(path);
+}
+
+// Sets the routes between a device and every other device to -1, in whichever layout the network uses. If
+// later_devices_only is set, only the routes between the device and the devices after it are cleared. The routes from a
+// device are next to each other in the route slab, so they are cleared with memset rather than one at a time
+void clear_routing_table(Network* self, int device_index, bool later_devices_only) {
+	int first_device = later_devices_only ? device_index + 1 : 0; // The first device whose routes are cleared
+	size_t row_start = (size_t)device_index * self->vertices + first_device; // The index of the first route in the slab
+
+	if (first_device >= self->vertices) {
+		return;
+	}
+
+	if (self->route_layout == ROUTES_PER_DEVICE) {
+		for (int i = first_device; i < self->vertices; i++) {
+			self->devices[device_index].routes[i].next_hop = -1;
+			self->devices[device_index].routes[i].cost = -1;
+		}
+		return;
+	}
+
+	// Every byte being 0xFF is -1 for each of the widths
+	memset(
+		(char*)self->route_slab.next_hops + row_start * self->route_slab.next_hop_bytes,
+		0xFF,
+		(size_t)(self->vertices - first_device) * self->route_slab.next_hop_bytes
+	);
+
+	if (self->route_layout == ROUTES_COMPACT) {
+		memset(
+			(char*)self->route_slab.costs + row_start * self->route_slab.cost_bytes,
+			0xFF,
+			(size_t)(self->vertices - first_device) * self->route_slab.cost_bytes
+		);
+		return;
+	}
+
+	// In the symmetric layout the costs to the devices after this one are next to each other, but the costs from the
+	// devices before it and the next hops back to it are spread out
+	if (device_index < self->vertices - 1) {
+		memset(
+			(char*)self->route_slab.costs + find_route_slab_cost_index(self, device_index, device_index + 1) * self->route_slab.cost_bytes,
+			0xFF,
+			(size_t)(self->vertices - 1 - device_index) * self->route_slab.cost_bytes
+		);
+	}
+
+	for (int i = first_device; i < self->vertices; i++) {
+		if (i == device_index) {
+			continue;
+		}
+
+		write_route_field(self->route_slab.next_hops, self->route_slab.next_hop_bytes, (size_t)i * self->vertices + device_index, -1);
+		if (i < device_index) {
+			write_route_field(
+				self->route_slab.costs, self->route_slab.cost_bytes, find_route_slab_cost_index(self, i, device_index), -1
+			);
+		}
+	}
+}
+
+// Builds the routing table of a device from the results of a search from it, in whichever layout the network uses. Every
+// device outside of the device's component is unreachable, so the table is cleared in bulk and then only the routes within
+// the component are filled in. In the symmetric layout, the route from each device back to the source costs the same as
+// the route to it and its next hop is the device before it on the shortest path from the source, so both directions come
+// from one search. Does nothing if the results are only wanted in the working memory
+void build_routing_table_from_scratch(Network* self, RoutingScratch* scratch, int device_index) {
+	int component = self->component_ids[device_index]; // The component of the source device
+	int current_device; // The device whose route is being filled in
+
+	if (!scratch->store_routes) {
+		return;
+	}
+
+	allocate_routes(self);
+	clear_routing_table(self, device_index, scratch->later_devices_only);
+
+	for (int i = self->component_offsets[component]; i < self->component_offsets[component + 1]; i++) {
+		current_device = self->component_devices[i];
+		if (current_device == device_index || (scratch->later_devices_only && current_device < device_index)) {
+			continue;
+		}
+
+		// If device can be reached
+		if (scratch->first_hops[current_device] != -1) {
+			set_route(self, device_index, current_device, scratch->first_hops[current_device], scratch->distances[current_device]);
+			COUNT_ROUTING(scratch->counters, routes_stored, 1);
+			if (self->route_layout == ROUTES_SYMMETRIC) {
+				set_route(self, current_device, device_index, scratch->previous[current_device], scratch->distances[current_device]);
+				COUNT_ROUTING(scratch->counters, routes_stored, 1);
+			}
+		}
+	}
+}
+
+// Returns the number of devices after the given source device in its component that a search from it has to reach before
+// it can stop, or -1 if the search has to reach every device
+int count_later_devices_needed(Network* self, int device_index, RoutingScratch* scratch) {
+	int component; // The component of the source device
+	int low; // The start of the part of the component that the first later device is in
+	int high; // The end of the part of the component that the first later device is in
+	int middle; // The position being checked
+
+	if (!scratch->later_devices_only) {
+		return -1;
+	}
+
+	// The component's devices are in increasing order, so the first one after the source is found with a binary search
+	component = self->component_ids[device_index];
+	low = self->component_offsets[component];
+	high = self->component_offsets[component + 1];
+	while (low < high) {
+		middle = (low + high) / 2;
+
+		if (self->component_devices[middle] <= device_index) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+
+	return self->component_offsets[component + 1] - low;
+}
+
+// Gets the working memory ready for a search from a device and returns the device's component. If the last search was in
+// another component, that component's devices are reset to unreached, so that each search only has to set up the devices
+// in its own component
+int start_component_search(Network* self, int device_index, RoutingScratch* scratch) {
+	int component = self->component_ids[device_index]; // The component being searched
+	int first_index = 0; // The position in the component devices of the first device to reset
+	int last_index = self->vertices; // The position after the last device to reset
+
+	if (scratch->searched_component == component) {
+		return component;
+	}
+
+	// Before the first search every device is reset, as the working memory has not been set up at all
+	if (scratch->searched_component != -1) {
+		first_index = self->component_offsets[scratch->searched_component];
+		last_index = self->component_offsets[scratch->searched_component + 1];
+	}
+
+	for (int i = first_index; i < last_index; i++) {
+		scratch->distances[self->component_devices[i]] = INT_MAX;
+		scratch->previous[self->component_devices[i]] = -1;
+		scratch->first_hops[self->component_devices[i]] = -1;
+		scratch->known[self->component_devices[i]] = false;
+	}
+
+	scratch->searched_component = component;
+	return component;
+}
+
+// Creates and returns the working memory needed to find the shortest paths from one device in the network
+RoutingScratch create_routing_scratch(Network* self) {
+	RoutingScratch new_scratch; // The newly created working memory
+
+	new_scratch.distances = malloc((sizeof(int)) * self->vertices);
+	new_scratch.previous = malloc((sizeof(int)) * self->vertices);
+	new_scratch.first_hops = malloc((sizeof(int)) * self->vertices);
+	new_scratch.known = malloc((sizeof(bool)) * self->vertices);
+	new_scratch.fifo_queue = malloc((sizeof(int)) * self->vertices);
+	new_scratch.heap = create_indexed_heap(self->vertices);
+
+	// Only make the bucket queue if it can be used, as it has a bucket for every possible speed
+	if (self->max_speed <= BUCKET_QUEUE_MAX_SPEED) {
+		new_scratch.buckets = create_bucket_queue(self->vertices, self->max_speed);
+	}
+	else {
+		new_scratch.buckets.bucket_heads = NULL;
+	}
+
+	new_scratch.later_devices_only = false;
+	new_scratch.store_routes = true;
+	new_scratch.searched_component = -1;
+	memset(&new_scratch.counters, 0, sizeof new_scratch.counters);
+
+	return new_scratch;
+}
+
+// Frees the working memory used to find shortest paths
+void delete_routing_scratch(RoutingScratch* self) {
+	free(self->distances);
+	free(self->previous);
+	free(self->first_hops);
+	free(self->known);
+	free(self->fifo_queue);
+	delete_indexed_heap(&self->heap);
+	if (self->buckets.bucket_heads != NULL) {
+		delete_bucket_queue(&self->buckets);
+	}
+}
+
+// Creates a routing table for a device using Dijkstra's shortest path algorithm, using the given working memory
+// Assumes that the graph has no negative weights and that it has more than 1 vertex
+// Some errors were found and troubleshooted with help from ChatGPT for this function
+void run_dijkstra(Network* self, int device_index, RoutingScratch* scratch) {
+	int* distances = scratch->distances; // An array of distances
+	bool* known = scratch->known; // An array of visitations
+	int* previous = scratch->previous; // An array storing the previous hop of each device
+	int* first_hops = scratch->first_hops; // An array storing the first hop from the source device to each device
+	int later_devices_left = count_later_devices_needed(self, device_index, scratch); // Later devices still to be reached
+	int component = start_component_search(self, device_index, scratch); // The component being searched
+	int component_start = self->component_offsets[component]; // The position of the component's first device
+	int component_end = self->component_offsets[component + 1]; // The position after the component's last device
+	int* component_devices = self->component_devices; // The devices of every component, grouped by component
+	int current_device; // The currently assessed device
+	Link* current_link;
+
+	// Initialise distances. Devices outside of the component are already unreached
+	for (int i = component_start; i < component_end; i++)
+	{	
+		distances[component_devices[i]] = INT_MAX; // Closest we can get to infinity with an INT
+		previous[component_devices[i]] = -1;
+		first_hops[component_devices[i]] = -1;
+		known[component_devices[i]] = false;
+	}
+
+	distances[device_index] = 0;
+
+	// Every device in the component can be reached, so one more becomes known on each step until they all are
+	for (int step = component_start; step < component_end; step++) {
+		current_device = -1; // Reset current device
+
+		// Find device with shortest distance that is still unknown and make it the current_device
+		for (int i = component_start; i < component_end; i++)
+		{
+			// Condition makes it so that if two unknown devices have the same distance, the one that comes first in the
+			// array is assessed first
+			if (!known[component_devices[i]] && (current_device == -1 || distances[component_devices[i]] < distances[current_device])) {
+				current_device = component_devices[i];
+			}
+		}
+
+		COUNT_ROUTING(scratch->counters, devices_settled, 1);
+
+		// When only the routes to later devices are needed, the search is finished once they are all known
+		if (current_device > device_index) {
+			later_devices_left--;
+			if (later_devices_left == 0) {
+				break;
+			}
+		}
+
+		// Traverse linked devices and overwrite paths if needed
+		for (int i = self->link_offsets[current_device]; i < self->link_offsets[current_device + 1]; i++) {
+			current_link = &self->packed_links[i];
+			COUNT_ROUTING(scratch->counters, links_relaxed, 1);
+
+			if (
+				!known[current_link->to_device] && 
+				distances[current_device] + current_link->speed < distances[current_link->to_device]
+			) {
+				distances[current_link->to_device] = distances[current_device] + current_link->speed;
+				previous[current_link->to_device] = current_device;
+				COUNT_ROUTING(scratch->counters, successful_relaxations, 1);
+
+				// Devices linked to the source device are their own first hop, the rest share the first hop of the device before them
+				if (current_device == device_index) {
+					first_hops[current_link->to_device] = current_link->to_device;
+				}
+				else {
+					first_hops[current_link->to_device] = first_hops[current_device];
+				}
+			}
+		}
+
+		known[current_device] = true;
+	}
+
+	build_routing_table_from_scratch(self, scratch, device_index);
+}
+
+// Creates a routing table for a device using Dijkstra's shortest path algorithm, keeping the unknown devices in an indexed
+// binary heap so that the closest one can be found in O(log V) rather than with a scan over every device. Assumes that the
+// graph has no negative weights
+void run_dijkstra_heap(Network* self, int device_index, RoutingScratch* scratch) {
+	int* distances = scratch->distances; // An array of distances
+	int* previous = scratch->previous; // An array storing the previous hop of each device
+	int* first_hops = scratch->first_hops; // An array storing the first hop from the source device to each device
+	IndexedHeap* unknown_devices = &scratch->heap; // The reached devices whose distance is not yet final
+	int later_devices_left = count_later_devices_needed(self, device_index, scratch); // Later devices still to be reached
+	int component; // The component being searched
+	int current_device; // The currently assessed device
+	uint32_t* packed_edges = self->packed_edges.edges; // The packed edges, or NULL to read the packed links
+	int to_device; // The device the current link goes to
+	int speed; // The speed of the current link
+
+	// Initialise distances. Devices outside of the component are already unreached
+	component = start_component_search(self, device_index, scratch);
+	for (int i = self->component_offsets[component]; i < self->component_offsets[component + 1]; i++)
+	{
+		distances[self->component_devices[i]] = INT_MAX;
+		previous[self->component_devices[i]] = -1;
+		first_hops[self->component_devices[i]] = -1;
+	}
+
+	distances[device_index] = 0;
+	heap_push_or_decrease(unknown_devices, device_index, 0);
+	COUNT_ROUTING(scratch->counters, queue_operations, 1);
+
+	// Devices that are never pushed are unreachable, so the search is finished once the heap runs out
+	while (!heap_is_empty(unknown_devices)) {
+		current_device = heap_pop_min(unknown_devices).device;
+		COUNT_ROUTING(scratch->counters, queue_operations, 1);
+		COUNT_ROUTING(scratch->counters, devices_settled, 1);
+
+		// When only the routes to later devices are needed, the search is finished once they are all known. The heap is
+		// emptied for the next search
+		if (current_device > device_index) {
+			later_devices_left--;
+			if (later_devices_left == 0) {
+				heap_clear(unknown_devices);
+				break;
+			}
+		}
+
+		// Traverse linked devices and overwrite paths if needed. Known devices can never pass this check as weights are not
+		// negative
+		for (int i = self->link_offsets[current_device]; i < self->link_offsets[current_device + 1]; i++) {
+			if (packed_edges != NULL) {
+				to_device = (int)(packed_edges[i] >> SPEED_CLASS_BITS);
+				speed = self->packed_edges.speeds[packed_edges[i] & (SPEED_CLASS_COUNT - 1)];
+			}
+			else {
+				to_device = self->packed_links[i].to_device;
+				speed = self->packed_links[i].speed;
+			}
+			COUNT_ROUTING(scratch->counters, links_relaxed, 1);
+
+			if (distances[current_device] + speed < distances[to_device]) {
+				distances[to_device] = distances[current_device] + speed;
+				previous[to_device] = current_device;
+				COUNT_ROUTING(scratch->counters, successful_relaxations, 1);
+
+				// Devices linked to the source device are their own first hop, the rest share the first hop of the device before them
+				if (current_device == device_index) {
+					first_hops[to_device] = to_device;
+				}
+				else {
+					first_hops[to_device] = first_hops[current_device];
+				}
+				heap_push_or_decrease(unknown_devices, to_device, distances[to_device]);
+				COUNT_ROUTING(scratch->counters, queue_operations, 1);
+			}
+		}
+	}
+
+	build_routing_table_from_scratch(self, scratch, device_index);
+}
+
+// Creates a routing table for a device using Dijkstra's shortest path algorithm, keeping the unknown devices in a circular
+// bucket queue (Dial's algorithm). The link speeds are small integers, so each bucket holds every device at one distance and
+// the closest device is found by moving to the next non-empty bucket. Falls back to the heap version when the network has a
+// link slower than BUCKET_QUEUE_MAX_SPEED. Assumes that the graph has no negative weights
+void run_dijkstra_buckets(Network* self, int device_index, RoutingScratch* scratch) {
+	int* distances = scratch->distances; // An array of distances
+	int* previous = scratch->previous; // An array storing the previous hop of each device
+	int* first_hops = scratch->first_hops; // An array storing the first hop from the source device to each device
+	BucketQueue* unknown_devices = &scratch->buckets; // The reached devices whose distance is not yet final
+	int later_devices_left = count_later_devices_needed(self, device_index, scratch); // Later devices still to be reached
+	int component; // The component being searched
+	int current_device; // The currently assessed device
+	uint32_t* packed_edges = self->packed_edges.edges; // The packed edges, or NULL to read the packed links
+	int to_device; // The device the current link goes to
+	int speed; // The speed of the current link
+
+	if (self->max_speed > BUCKET_QUEUE_MAX_SPEED) {
+		run_dijkstra_heap(self, device_index, scratch);
+		return;
+	}
+
+	// Initialise distances. Devices outside of the component are already unreached
+	component = start_component_search(self, device_index, scratch);
+	for (int i = self->component_offsets[component]; i < self->component_offsets[component + 1]; i++)
+	{
+		distances[self->component_devices[i]] = INT_MAX;
+		previous[self->component_devices[i]] = -1;
+		first_hops[self->component_devices[i]] = -1;
+	}
+
+	distances[device_index] = 0;
+	bucket_push_or_decrease(unknown_devices, device_index, 0);
+	COUNT_ROUTING(scratch->counters, queue_operations, 1);
+
+	while (unknown_devices->size > 0) {
+		current_device = bucket_pop_min(unknown_devices).device;
+		COUNT_ROUTING(scratch->counters, queue_operations, 1);
+		COUNT_ROUTING(scratch->counters, devices_settled, 1);
+
+		// When only the routes to later devices are needed, the search is finished once they are all known. The queue is
+		// emptied for the next search
+		if (current_device > device_index) {
+			later_devices_left--;
+			if (later_devices_left == 0) {
+				bucket_clear(unknown_devices);
+				break;
+			}
+		}
+
+		// Traverse linked devices and overwrite paths if needed
+		for (int i = self->link_offsets[current_device]; i < self->link_offsets[current_device + 1]; i++) {
+			if (packed_edges != NULL) {
+				to_device = (int)(packed_edges[i] >> SPEED_CLASS_BITS);
+				speed = self->packed_edges.speeds[packed_edges[i] & (SPEED_CLASS_COUNT - 1)];
+			}
+			else {
+				to_device = self->packed_links[i].to_device;
+				speed = self->packed_links[i].speed;
+			}
+			COUNT_ROUTING(scratch->counters, links_relaxed, 1);
+
+			if (distances[current_device] + speed < distances[to_device]) {
+				distances[to_device] = distances[current_device] + speed;
+				previous[to_device] = current_device;
+				COUNT_ROUTING(scratch->counters, successful_relaxations, 1);
+
+				// Devices linked to the source device are their own first hop, the rest share the first hop of the device before them
+				if (current_device == device_index) {
+					first_hops[to_device] = to_device;
+				}
+				else {
+					first_hops[to_device] = first_hops[current_device];
+				}
+				bucket_push_or_decrease(unknown_devices, to_device, distances[to_device]);
+				COUNT_ROUTING(scratch->counters, queue_operations, 1);
+			}
+		}
+	}
+
+	build_routing_table_from_scratch(self, scratch, device_index);
+}
+
+// Creates a routing table for a device using the Bellman-Ford shortest path algorithm, using the given working memory.
+// Relaxes the network's edge list, which must already be built, or its packed edges if it has them. The packed edges are
+// relaxed in the same order, going through the links of each device in the component. Stops early once a pass makes no
+// changes, as no later pass could make any either
+// ChatGPT gave basic pseudocode to explain how Bellman-Ford works and was used for debugging.
+void run_bellman_ford(Network* self, int device_index, RoutingScratch* scratch) {
+	int* distances = scratch->distances; // An array of distances
+	int* previous = scratch->previous; // An array storing the previous hop of each device
+	int* first_hops = scratch->first_hops; // An array storing the first hop from the source device to each device
+	EdgeList* edges = &self->edges; // Every link in the network
+	uint32_t* packed_edges = self->packed_edges.edges; // The packed edges, or NULL to read the edge list
+	bool changed = true; // Whether the last pass shortened any distance
+	int from_device; // The device the current link comes from
+	int to_device; // The device the current link goes to
+	int speed; // The speed of the current link
+	int component; // The component being searched
+	int component_size; // The number of devices in the component
+	
+	// Initialise distances. Devices outside of the component are already unreached
+	component = start_component_search(self, device_index, scratch);
+	for (int i = self->component_offsets[component]; i < self->component_offsets[component + 1]; i++)
+	{
+		distances[self->component_devices[i]] = INT_MAX;
+		previous[self->component_devices[i]] = -1;
+		first_hops[self->component_devices[i]] = -1;
+	}
+
+	distances[device_index] = 0;
+	component_size = self->component_offsets[component + 1] - self->component_offsets[component];
+
+	// Run relaxations. A shortest path within the component has fewer links than the component has devices
+	for (int i = 0; i < component_size - 1 && changed; i++)
+	{
+		changed = false;
+		COUNT_ROUTING(scratch->counters, bellman_ford_passes, 1);
+
+		if (packed_edges != NULL) {
+			for (int j = self->component_offsets[component]; j < self->component_offsets[component + 1]; j++) {
+				from_device = self->component_devices[j];
+				if (distances[from_device] == INT_MAX) {
+					continue;
+				}
+
+				for (int k = self->link_offsets[from_device]; k < self->link_offsets[from_device + 1]; k++) {
+					to_device = (int)(packed_edges[k] >> SPEED_CLASS_BITS);
+					speed = self->packed_edges.speeds[packed_edges[k] & (SPEED_CLASS_COUNT - 1)];
+					COUNT_ROUTING(scratch->counters, links_relaxed, 1);
+
+					if (distances[from_device] + speed < distances[to_device]) {
+						distances[to_device] = distances[from_device] + speed;
+						previous[to_device] = from_device;
+						COUNT_ROUTING(scratch->counters, successful_relaxations, 1);
+
+						// Devices linked to the source device are their own first hop, the rest share the first hop of the device before them
+						if (from_device == device_index) {
+							first_hops[to_device] = to_device;
+						}
+						else {
+							first_hops[to_device] = first_hops[from_device];
+						}
+						changed = true;
+					}
+				}
+			}
+
+			continue;
+		}
+
+		for (int j = 0; j < edges->count; j++) {
+			COUNT_ROUTING(scratch->counters, links_relaxed, 1);
+
+			if (
+				distances[edges->from_devices[j]] != INT_MAX && 
+				distances[edges->from_devices[j]] + edges->speeds[j] < distances[edges->to_devices[j]]
+			) {
+				distances[edges->to_devices[j]] = distances[edges->from_devices[j]] + edges->speeds[j];
+				previous[edges->to_devices[j]] = edges->from_devices[j];
+				COUNT_ROUTING(scratch->counters, successful_relaxations, 1);
+
+				// Devices linked to the source device are their own first hop, the rest share the first hop of the device before them
+				if (edges->from_devices[j] == device_index) {
+					first_hops[edges->to_devices[j]] = edges->to_devices[j];
+				}
+				else {
+					first_hops[edges->to_devices[j]] = first_hops[edges->from_devices[j]];
+				}
+				changed = true;
+			}
+		}
+	}
+
+	// Make unreachable distances equal -1
+	for (int i = self->component_offsets[component]; i < self->component_offsets[component + 1]; i++) {
+		if (distances[self->component_devices[i]] == INT_MAX) {
+			distances[self->component_devices[i]] = -1;
+		}
+	}
+
+	build_routing_table_from_scratch(self, scratch, device_index);
+}
+
+// Creates a routing table for a device using the Shortest Path Faster Algorithm (SPFA), using the given working memory. This
+// is Bellman-Ford where, instead of relaxing every link on each pass, only the links out of devices whose distance has just
+// changed are relaxed. Those devices wait in a first-in first-out queue, and a device is never in the queue twice. Like
+// Bellman-Ford it allows negative speeds, and it gives up after as many relaxations as V full passes would make, which
+// only happens if there is a negative cycle
+void run_spfa(Network* self, int device_index, RoutingScratch* scratch) {
+	int* distances = scratch->distances; // An array of distances
+	int* previous = scratch->previous; // An array storing the previous hop of each device
+	int* first_hops = scratch->first_hops; // An array storing the first hop from the source device to each device
+	bool* queued = scratch->known; // Whether each device is currently in the queue
+	int* queue = scratch->fifo_queue; // A circular queue of devices whose links need relaxing
+	int queue_start = 0; // The position of the first device in the queue
+	int queue_size = 0; // The number of devices in the queue
+	long long relaxations_left = (long long)self->vertices * self->link_count; // Relaxations before giving up
+	int component; // The component being searched
+	int current_device; // The currently assessed device
+	uint32_t* packed_edges = self->packed_edges.edges; // The packed edges, or NULL to read the packed links
+	int to_device; // The device the current link goes to
+	int speed; // The speed of the current link
+
+	// Initialise distances. Devices outside of the component are already unreached
+	component = start_component_search(self, device_index, scratch);
+	for (int i = self->component_offsets[component]; i < self->component_offsets[component + 1]; i++)
+	{
+		distances[self->component_devices[i]] = INT_MAX;
+		previous[self->component_devices[i]] = -1;
+		first_hops[self->component_devices[i]] = -1;
+		queued[self->component_devices[i]] = false;
+	}
+
+	distances[device_index] = 0;
+	queue[0] = device_index;
+	queued[device_index] = true;
+	queue_size = 1;
+	COUNT_ROUTING(scratch->counters, queue_operations, 1);
+
+	while (queue_size > 0 && relaxations_left > 0) {
+		current_device = queue[queue_start];
+		queue_start = (queue_start + 1) % self->vertices;
+		queue_size--;
+		queued[current_device] = false;
+		COUNT_ROUTING(scratch->counters, queue_operations, 1);
+		COUNT_ROUTING(scratch->counters, devices_settled, 1);
+
+		// Relax the links out of the device, queueing any device whose distance is shortened
+		for (int i = self->link_offsets[current_device]; i < self->link_offsets[current_device + 1]; i++) {
+			if (packed_edges != NULL) {
+				to_device = (int)(packed_edges[i] >> SPEED_CLASS_BITS);
+				speed = self->packed_edges.speeds[packed_edges[i] & (SPEED_CLASS_COUNT - 1)];
+			}
+			else {
+				to_device = self->packed_links[i].to_device;
+				speed = self->packed_links[i].speed;
+			}
+			relaxations_left--;
+			COUNT_ROUTING(scratch->counters, links_relaxed, 1);
+
+			if (distances[current_device] + speed < distances[to_device]) {
+				distances[to_device] = distances[current_device] + speed;
+				previous[to_device] = current_device;
+				COUNT_ROUTING(scratch->counters, successful_relaxations, 1);
+
+				// Devices linked to the source device are their own first hop, the rest share the first hop of the device before them
+				if (current_device == device_index) {
+					first_hops[to_device] = to_device;
+				}
+				else {
+					first_hops[to_device] = first_hops[current_device];
+				}
+
+				if (!queued[to_device]) {
+					queue[(queue_start + queue_size) % self->vertices] = to_device;
+					queue_size++;
+					queued[to_device] = true;
+					COUNT_ROUTING(scratch->counters, queue_operations, 1);
+				}
+			}
+		}
+	}
+
+	build_routing_table_from_scratch(self, scratch, device_index);
+}
+
+// Finds the histogram bucket of a value, which is the number of bits needed to hold it
+int find_histogram_bucket(long long value) {
+	int bucket = 0; // The bucket of the value
+
+	while (value > 0 && bucket < ROUTING_HISTOGRAM_BUCKETS - 1) {
+		value >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+// Counts a finished search from one source device, with the time it took and the number of links it relaxed
+void count_routing_search(RoutingCounters* self, long long nanoseconds, long long links_relaxed) {
+	self->sources++;
+	self->nanoseconds += nanoseconds;
+	self->time_histogram[find_histogram_bucket(nanoseconds)]++;
+	self->links_relaxed_histogram[find_histogram_bucket(links_relaxed)]++;
+}
+
+// Adds one set of routing counters to another
+void add_routing_counters(RoutingCounters* self, RoutingCounters* counters) {
+	self->sources += counters->sources;
+	self->nanoseconds += counters->nanoseconds;
+	self->devices_settled += counters->devices_settled;
+	self->links_relaxed += counters->links_relaxed;
+	self->successful_relaxations += counters->successful_relaxations;
+	self->queue_operations += counters->queue_operations;
+	self->bellman_ford_passes += counters->bellman_ford_passes;
+	self->routes_stored += counters->routes_stored;
+
+	for (int i = 0; i < ROUTING_HISTOGRAM_BUCKETS; i++) {
+		self->time_histogram[i] += counters->time_histogram[i];
+		self->links_relaxed_histogram[i] += counters->links_relaxed_histogram[i];
+	}
+}
+
+// Gets a copy of a network's routing counters
+RoutingCounters get_routing_counters(Network* self) {
+	return self->routing_counters;
+}
+
+// Sets every routing counter of a network back to 0
+void reset_routing_counters(Network* self) {
+	memset(&self->routing_counters, 0, sizeof self->routing_counters);
+}
+
+// Relaxes one row of the cost matrix through a middle device. Every route from the row's device to a device from start up
+// to (not including) end that is shorter through the middle device takes that cost, and the next hop towards the middle
+// device. Four costs are relaxed at a time with SSE2 when it is available, choosing between the old and new values with
+// a mask instead of branching
+void relax_floyd_warshall_row(
+	int* row_costs, int* row_hops, int* middle_costs, int cost_to_middle, int hop_to_middle, int start, int end
+) {
+	int column = start; // The device the route being relaxed goes to
+#ifdef FLOYD_WARSHALL_SSE2
+	__m128i costs_to_middle = _mm_set1_epi32(cost_to_middle); // The cost to the middle device, in each lane
+	__m128i hops_to_middle = _mm_set1_epi32(hop_to_middle); // The next hop towards the middle device, in each lane
+	__m128i through_costs; // The costs of four routes through the middle device
+	__m128i current_costs; // The costs of the same four routes so far
+	__m128i current_hops; // The next hops of the same four routes so far
+	__m128i shorter; // All ones in each lane where the route through the middle device is shorter
+
+	for (; column + 4 <= end; column += 4) {
+		through_costs = _mm_add_epi32(costs_to_middle, _mm_loadu_si128((__m128i*)&middle_costs[column]));
+		current_costs = _mm_loadu_si128((__m128i*)&row_costs[column]);
+		current_hops = _mm_loadu_si128((__m128i*)&row_hops[column]);
+		shorter = _mm_cmplt_epi32(through_costs, current_costs);
+
+		_mm_storeu_si128(
+			(__m128i*)&row_costs[column],
+			_mm_or_si128(_mm_and_si128(shorter, through_costs), _mm_andnot_si128(shorter, current_costs))
+		);
+		_mm_storeu_si128(
+			(__m128i*)&row_hops[column],
+			_mm_or_si128(_mm_and_si128(shorter, hops_to_middle), _mm_andnot_si128(shorter, current_hops))
+		);
+	}
+#endif
+
+	for (; column < end; column++) {
+		if (cost_to_middle + middle_costs[column] < row_costs[column]) {
+			row_costs[column] = cost_to_middle + middle_costs[column];
+			row_hops[column] = hop_to_middle;
+		}
+	}
+}
+
+// Relaxes the routes in one tile of the cost matrix through each middle device of another tile, where the tiles are
+// given by the first device of their rows, columns and middle devices. Routes with no cost to the middle device are
+// skipped, which also keeps the sums from overflowing
+void relax_floyd_warshall_tile(int* costs, int* next_hops, int vertices, int row_start, int column_start, int middle_start) {
+	int row_end = row_start + FLOYD_WARSHALL_TILE_SIZE < vertices ? row_start + FLOYD_WARSHALL_TILE_SIZE : vertices; // The end of the rows
+	int column_end = column_start + FLOYD_WARSHALL_TILE_SIZE < vertices ? column_start + FLOYD_WARSHALL_TILE_SIZE : vertices; // The end of the columns
+	int middle_end = middle_start + FLOYD_WARSHALL_TILE_SIZE < vertices ? middle_start + FLOYD_WARSHALL_TILE_SIZE : vertices; // The end of the middle devices
+	size_t row_index; // The index of the start of the current row
+
+	for (int k = middle_start; k < middle_end; k++) {
+		for (int i = row_start; i < row_end; i++) {
+			row_index = (size_t)i * vertices;
+			if (costs[row_index + k] == FLOYD_WARSHALL_NO_ROUTE) {
+				continue;
+			}
+
+			relax_floyd_warshall_row(
+				&costs[row_index],
+				&next_hops[row_index],
+				&costs[(size_t)k * vertices],
+				costs[row_index + k],
+				next_hops[row_index + k],
+				column_start,
+				column_end
+			);
+		}
+	}
+}
+
+// Builds every routing table with Floyd-Warshall. The costs and next hops are kept in two matrices with a row for each
+// device, which are updated a tile at a time so that the rows being read stay in the cache. For each tile of middle
+// devices, the tile on the diagonal is relaxed through itself first, then the tiles in its row and column, which only
+// need the diagonal tile, and then every other tile, which only needs the tiles in its row and column. The tiles of the
+// last two steps do not depend on each other, so they are shared between threads. Every route is then stored. Falls back
+// to Dijkstra's algorithm with a heap if a route could cost too much to add two costs together
+void build_routing_tables_floyd_warshall(Network* self, int thread_count) {
+	size_t matrix_size = (size_t)self->vertices * self->vertices; // The number of routes in each matrix
+	int tile_count = (self->vertices + FLOYD_WARSHALL_TILE_SIZE - 1) / FLOYD_WARSHALL_TILE_SIZE; // The tiles along each side
+	int* costs; // The cost of the shortest route found so far between each pair of devices
+	int* next_hops; // The next hop of the shortest route found so far between each pair of devices
+	int middle_start; // The first middle device of the current tile of middle devices
+	RoutingScratch scratch; // The working memory used if Floyd-Warshall cannot be used
+
+#ifndef _OPENMP
+	(void)thread_count; // The tiles are only shared between threads when OpenMP is enabled
+#endif
+
+	if (find_route_cost_bound(self) >= FLOYD_WARSHALL_NO_ROUTE) {
+		scratch = create_routing_scratch(self);
+		for (int i = 0; i < self->vertices; i++) {
+			find_shortest_paths(self, self->component_devices[i], ALGORITHM_DIJKSTRA_HEAP, &scratch);
+		}
+#ifdef ROUTING_COUNTERS
+		add_routing_counters(&self->routing_counters, &scratch.counters);
+#endif
+		delete_routing_scratch(&scratch);
+		return;
+	}
+
+	costs = malloc((sizeof(int)) * (matrix_size > 0 ? matrix_size : 1));
+	next_hops = malloc((sizeof(int)) * (matrix_size > 0 ? matrix_size : 1));
+
+	// Start from the fastest link between each pair of devices
+	for (size_t i = 0; i < matrix_size; i++) {
+		costs[i] = FLOYD_WARSHALL_NO_ROUTE;
+		next_hops[i] = -1;
+	}
+	for (int i = 0; i < self->vertices; i++) {
+		costs[(size_t)i * self->vertices + i] = 0;
+
+		for (int j = self->link_offsets[i]; j < self->link_offsets[i + 1]; j++) {
+			if (
+				self->packed_links[j].to_device != i &&
+				self->packed_links[j].speed < costs[(size_t)i * self->vertices + self->packed_links[j].to_device]
+			) {
+				costs[(size_t)i * self->vertices + self->packed_links[j].to_device] = self->packed_links[j].speed;
+				next_hops[(size_t)i * self->vertices + self->packed_links[j].to_device] = self->packed_links[j].to_device;
+			}
+		}
+	}
+
+	for (int k = 0; k < tile_count; k++) {
+		middle_start = k * FLOYD_WARSHALL_TILE_SIZE;
+		relax_floyd_warshall_tile(costs, next_hops, self->vertices, middle_start, middle_start, middle_start);
+
+#pragma omp parallel for num_threads(thread_count) schedule(dynamic, 1)
+		for (int i = 0; i < tile_count; i++) {
+			if (i != k) {
+				relax_floyd_warshall_tile(costs, next_hops, self->vertices, middle_start, i * FLOYD_WARSHALL_TILE_SIZE, middle_start);
+				relax_floyd_warshall_tile(costs, next_hops, self->vertices, i * FLOYD_WARSHALL_TILE_SIZE, middle_start, middle_start);
+			}
+		}
+
+#pragma omp parallel for num_threads(thread_count) schedule(dynamic, 1)
+		for (int i = 0; i < tile_count * tile_count; i++) {
+			if (i / tile_count != k && i % tile_count != k) {
+				relax_floyd_warshall_tile(
+					costs,
+					next_hops,
+					self->vertices,
+					i / tile_count * FLOYD_WARSHALL_TILE_SIZE,
+					i % tile_count * FLOYD_WARSHALL_TILE_SIZE,
+					middle_start
+				);
+			}
+		}
+	}
+
+	for (int i = 0; i < self->vertices; i++) {
+		for (int j = 0; j < self->vertices; j++) {
+			if (i == j || costs[(size_t)i * self->vertices + j] == FLOYD_WARSHALL_NO_ROUTE) {
+				set_route(self, i, j, -1, -1);
+			}
+			else {
+				set_route(self, i, j, next_hops[(size_t)i * self->vertices + j], costs[(size_t)i * self->vertices + j]);
+			}
+		}
+	}
+
+	free(costs);
+	free(next_hops);
+}
 
+// Creates a routing table for a device with the given algorithm, using the given working memory. Returns false if the
+// algorithm is not supported
+bool find_shortest_paths(Network* self, int device_index, int algorithm, RoutingScratch* scratch) {
+#ifdef ROUTING_COUNTERS
+	uint64_t start = get_monotonic_nanoseconds(); // The time the search started
+	long long links_relaxed = scratch->counters.links_relaxed; // The links relaxed by earlier searches
+#endif
 
-// Adds a new link to a network. Assumes that the network has both the to and from nodes within it
-void add_link(Network* self, int first_device, int second_device, int speed) {
-	LinkNodePtr new_link_node; // The new link node
-	LinkNodePtr opposite_link_node; // The new link node to add to the second device
+	if (self->component_ids == NULL) {
+		label_components(self);
+	}
 
-	// Create new node and assign values
-	new_link_node = malloc(sizeof * new_link_node);
-	new_link_node->link.to_device = second_device;
-	new_link_node->link.speed = speed;
-	new_link_node->next = self->devices[first_device].links.head;
+	// Every route of the last device in a component was filled in by the searches from the devices before it, apart from
+	// its routes to the later devices in other components
+	if (count_later_devices_needed(self, device_index, scratch) == 0) {
+		if (scratch->store_routes) {
+			allocate_routes(self);
+			clear_routing_table(self, device_index, true);
+		}
+		return true;
+	}
 
-	// Add the link the other way
-	opposite_link_node = malloc(sizeof * opposite_link_node);
-	opposite_link_node->link.to_device = first_device;
-	opposite_link_node->link.speed = speed;
-	opposite_link_node->next = self->devices[second_device].links.head;
+	if (algorithm == ALGORITHM_DIJKSTRA) {
+		run_dijkstra(self, device_index, scratch);
+	}
+	else if (algorithm == ALGORITHM_BELLMAN_FORD) {
+		run_bellman_ford(self, device_index, scratch);
+	} 
+	else if (algorithm == ALGORITHM_DIJKSTRA_HEAP || algorithm == ALGORITHM_FLOYD_WARSHALL) {
+		run_dijkstra_heap(self, device_index, scratch);
+	}
+	else if (algorithm == ALGORITHM_DIJKSTRA_BUCKETS) {
+		run_dijkstra_buckets(self, device_index, scratch);
+	}
+	else if (algorithm == ALGORITHM_SPFA) {
+		run_spfa(self, device_index, scratch);
+	}
+	else {
+		return false;
+	}
 
+#ifdef ROUTING_COUNTERS
+	count_routing_search(
+		&scratch->counters, (long long)(get_monotonic_nanoseconds() - start), scratch->counters.links_relaxed - links_relaxed
+	);
+#endif
 
-	self->devices[first_device].links.head = new_link_node;
-	self->devices[second_device].links.head = opposite_link_node;
+	return true;
 }
 
-// Builds and returns network from given file
-Network* build_network_from_file(String filepath) {
-	FILE* file = fopen(filepath, "r");			// The file to read from
-	Network* new_network = malloc(sizeof(Network));   // The new network
-	int first_device;  // The first device from the currently iterated row of the file
-	int second_device; // The second device from the currently iterated row of the file
-	int speed; // The speed of the connection between the devices from the currently iterated row of the file
+// Freezes the network and builds anything else that the algorithm reads, so that the algorithm never changes the network
+void prepare_network_for_routing(Network* self, int algorithm) {
+	freeze_network(self);
 
-	// Stop function if file is not valid
-	if (file == NULL) {
-		printf("Error opening file!\n");
-		return NULL;
+	// Bellman-Ford reads the packed edges instead of the edge list when there are any
+	if (self->pack_edges) {
+		build_packed_edges(self);
+	}
+	if (algorithm == ALGORITHM_BELLMAN_FORD && self->packed_edges.edges == NULL) {
+		build_edge_list(self);
 	}
 
-	fscanf_s(file, "%d", &new_network->vertices);
+	if (self->component_ids == NULL) {
+		label_components(self);
+	}
 
-	// Initilise each device and allocate memory
-	new_network->devices = malloc((sizeof * new_network->devices) * new_network->vertices);
-	for (int i = 0; i < new_network->vertices; i++)
-	{
-		new_network->devices[i].links.head = NULL;
+	// Links may have been added since the route slab was made, so its costs might need to be wider for the new routes
+	if (self->routes_allocated && self->route_layout != ROUTES_PER_DEVICE) {
+		widen_route_slab_costs(self, find_route_cost_bound(self));
+	}
+	allocate_routes(self);
+}
+
+// Creates a routing table for a device using one of the algorithms, with working memory that is only used for this device
+void find_shortest_paths_for_device(Network* self, int device_index, int algorithm) {
+	RoutingScratch scratch; // The working memory for the algorithm
+
+	prepare_network_for_routing(self, algorithm);
+
+	scratch = create_routing_scratch(self);
+	find_shortest_paths(self, device_index, algorithm, &scratch);
+#ifdef ROUTING_COUNTERS
+	add_routing_counters(&self->routing_counters, &scratch.counters);
+#endif
+	delete_routing_scratch(&scratch);
+}
+
+// Creates a routing table for a device using Dijkstra's shortest path algorithm
+void find_shortest_paths_dijkstra(Network* self, int device_index) {
+	find_shortest_paths_for_device(self, device_index, ALGORITHM_DIJKSTRA);
+}
+
+// Creates a routing table for a device using Dijkstra's shortest path algorithm with an indexed binary heap
+void find_shortest_paths_dijkstra_heap(Network* self, int device_index) {
+	find_shortest_paths_for_device(self, device_index, ALGORITHM_DIJKSTRA_HEAP);
+}
+
+// Creates a routing table for a device using Dijkstra's shortest path algorithm with a circular bucket queue
+void find_shortest_paths_dijkstra_buckets(Network* self, int device_index) {
+	find_shortest_paths_for_device(self, device_index, ALGORITHM_DIJKSTRA_BUCKETS);
+}
+
+// Creates a routing table for a device using the Bellman-Ford shortest path algorithm
+void find_shortest_paths_bellman_ford(Network* self, int device_index) {
+	find_shortest_paths_for_device(self, device_index, ALGORITHM_BELLMAN_FORD);
+}
+
+// Creates a routing table for a device using the Shortest Path Faster Algorithm
+void find_shortest_paths_spfa(Network* self, int device_index) {
+	find_shortest_paths_for_device(self, device_index, ALGORITHM_SPFA);
+}
+
+// Predicts how long building every routing table with an algorithm takes on one thread in milliseconds. Each search
+// from a device relaxes every link and settles every device once, apart from SPFA, which goes over the links again each
+// time a shorter route is found. That happens more often the more links each device has beyond the one or two that a
+// chain or tree of devices has. Floyd-Warshall relaxes every pair of devices through every device, four at a time. The
+// bucket queue also steps over empty buckets, at most the largest link speed of them between two settled devices. That
+// time was measured as part of COST_BUCKET_DEVICE, so it is not counted separately
+double predict_routing_cost(Network* self, int algorithm) {
+	double vertices = self->vertices; // The number of devices
+	double links; // The number of links, counting each direction
+	double extra_links; // How many links each device has beyond the two of a chain
+	double source_cost; // The predicted time for a search from one device in nanoseconds
+
+	freeze_network(self);
+	links = self->link_count;
+
+	if (algorithm == ALGORITHM_DIJKSTRA_HEAP) {
+		source_cost = COST_HEAP_LINK * links + COST_HEAP_DEVICE * vertices * log2(vertices > 2 ? vertices : 2);
+	}
+	else if (algorithm == ALGORITHM_DIJKSTRA_BUCKETS && self->max_speed <= BUCKET_QUEUE_MAX_SPEED) {
+		source_cost = COST_BUCKET_LINK * links + COST_BUCKET_DEVICE * vertices;
+	}
+	else if (algorithm == ALGORITHM_SPFA) {
+		extra_links = vertices > 0 ? links / vertices - 1 : 0;
+		source_cost = COST_SPFA_STEP * (links + vertices) * (extra_links > 1 ? extra_links : 1);
+	}
+	else if (algorithm == ALGORITHM_FLOYD_WARSHALL) {
+		source_cost = COST_FLOYD_WARSHALL_STEP * vertices * vertices;
+	}
+	else {
+		return -1;
+	}
 
-		new_network->devices[i].routes = malloc((sizeof * new_network->devices[i].routes) * new_network->vertices);
-		for (int j = 0; j < new_network->vertices; j++) {			
-			new_network->devices[i].routes[j].next_hop = -1;
-			new_network->devices[i].routes[j].cost = -1;
+	return vertices * source_cost / 1000000;
+}
+
+// Chooses the algorithm with the lowest predicted cost. The linear scan version of Dijkstra and Bellman-Ford take more steps
+// than the heap version and SPFA on every network, so they are not considered
+RoutingPlan choose_routing_algorithm(Network* self) {
+	const RoutingAlgorithm CANDIDATES[] = {
+		ALGORITHM_DIJKSTRA_HEAP, ALGORITHM_DIJKSTRA_BUCKETS, ALGORITHM_SPFA, ALGORITHM_FLOYD_WARSHALL
+	}; // The algorithms that can be chosen
+	RoutingPlan plan; // The plan with the lowest predicted cost so far
+	double cost; // The predicted cost of the current algorithm
+
+	plan.algorithm = ALGORITHM_DIJKSTRA_HEAP;
+	plan.predicted_cost = predict_routing_cost(self, ALGORITHM_DIJKSTRA_HEAP);
+
+	for (int i = 1; i < (int)(sizeof CANDIDATES / sizeof * CANDIDATES); i++) {
+		cost = predict_routing_cost(self, CANDIDATES[i]);
+		if (cost >= 0 && cost < plan.predicted_cost) {
+			plan.algorithm = CANDIDATES[i];
+			plan.predicted_cost = cost;
 		}
-		
 	}
 
-	// Add all links from file
-	while (fscanf_s(file, "%d,%d,%d", &first_device, &second_device, &speed) == 3) {
-		add_link(new_network, first_device, second_device, speed);
+	return plan;
+}
+
+// Gets the name of an algorithm
+String get_algorithm_name(int algorithm) {
+	const String NAMES[ALGORITHM_COUNT] = {
+		"Dijkstra", "Bellman-Ford", "Dijkstra (heap)", "Dijkstra (buckets)", "SPFA", "Floyd-Warshall"
+	}; // The name of each algorithm, in the order of RoutingAlgorithm
+
+	if (algorithm == ALGORITHM_AUTO) {
+		return "automatic";
+	}
+	if (algorithm < 0 || algorithm >= ALGORITHM_COUNT) {
+		return "unknown";
 	}
 
-	return new_network;
+	return NAMES[algorithm];
 }
 
-// Checks whether all devices within the known array are known or not and returns the answer
-bool all_devices_known(bool* known_array, int length) {
-	bool all_known = true;
+// Builds a routing table for each node in the network using a specified algorithm. 0 is for Dijkstra, 1 is for Bellman-Ford,
+// 2 is for Dijkstra with a heap, 3 is for Dijkstra with a bucket queue, 4 is for SPFA and 5 is for Floyd-Warshall. -1 chooses
+// one automatically
+void build_routing_tables(Network* self, int algorithm) {
+	build_routing_tables_parallel(self, algorithm, 1);
+}
 
-	for (int i = 0; i < length; i++)
+// Builds a routing table for each node in the network using a specified algorithm, sharing the source devices between
+// threads. Each source device only writes to its own routing table, so the threads never write to the same memory
+void build_routing_tables_parallel(Network* self, int algorithm, int thread_count) {
+	if (algorithm == ALGORITHM_AUTO) {
+		self->routing_plan = choose_routing_algorithm(self);
+		algorithm = self->routing_plan.algorithm;
+	}
+
+	// The bucket queue needs a bucket for every speed up to the largest one, so warn once and use the heap if that is too many
+	if (algorithm == ALGORITHM_DIJKSTRA_BUCKETS && self->max_speed > BUCKET_QUEUE_MAX_SPEED) {
+		printf("Warning: Link speed %d is too large for the bucket queue, using Dijkstra with a heap instead\n", self->max_speed);
+		algorithm = ALGORITHM_DIJKSTRA_HEAP;
+	}
+
+	if (algorithm < 0 || algorithm >= ALGORITHM_COUNT) {
+		printf("Error: Algorithm is not supported!");
+		return;
+	}
+
+	// Prepare the network before the threads start so that they only ever read it
+	prepare_network_for_routing(self, algorithm);
+
+#ifdef _OPENMP
+	if (thread_count <= 0) {
+		thread_count = omp_get_max_threads();
+	}
+#else
+	thread_count = 1;
+#endif
+
+	if (algorithm == ALGORITHM_FLOYD_WARSHALL) {
+		build_routing_tables_floyd_warshall(self, thread_count);
+		self->routes_current = true;
+		return;
+	}
+
+	// Each thread makes its own working memory once, then takes chunks of source devices from a shared counter until
+	// there are none left. Taking chunks as threads become free keeps every thread busy when some sources take longer
+#pragma omp parallel num_threads(thread_count)
 	{
-		if (!known_array[i]) {
-			all_known = false;
+		RoutingScratch scratch = create_routing_scratch(self); // The working memory for this thread
+
+		// Each pair of devices is then only searched for from the device with the lower index, which is also the only
+		// source that writes its cost, so no two threads write the same route
+		scratch.later_devices_only = self->route_layout == ROUTES_SYMMETRIC;
+
+		// Sources are taken a component at a time, so a thread's working memory is only reset when it moves to another one
+#pragma omp for schedule(dynamic, ROUTING_CHUNK_SIZE)
+		for (int i = 0; i < self->vertices; i++)
+		{
+			find_shortest_paths(self, self->component_devices[i], algorithm, &scratch);
 		}
+
+		// Each thread adds its counts to the network's once it has finished, so the threads only wait on each other once
+#ifdef ROUTING_COUNTERS
+#pragma omp critical
+		add_routing_counters(&self->routing_counters, &scratch.counters);
+#endif
+
+		delete_routing_scratch(&scratch);
 	}
 
-	return all_known;
+	self->routes_current = true;
 }
 
-// Builds a routing table from an array of distances between the source device and the destination device, and an array of 
-// the previous hops of each of the destination devices.
-void build_routing_table_from_distances(Network* self, int* previous, int* distances, int device_index) {
+// Checks whether the old route from a source device to another device might have gone through the link between the first
+// and second devices, from the old distances of both ends of the link to every device
+bool is_route_through_link(
+	Network* self, int source_device, int to_device, int* first_distances, int* second_distances, int old_speed
+) {
+	int distance = find_table_distance(self, source_device, to_device); // The old distance between the devices
+
+	if (distance == INT_MAX || to_device == source_device) {
+		return false;
+	}
+
+	return (long long)first_distances[source_device] + old_speed + second_distances[to_device] == distance ||
+		(long long)second_distances[source_device] + old_speed + first_distances[to_device] == distance;
+}
+
+// Finds the routes again after the link between two devices has been made slower or removed, without rebuilding any whole
+// routing table. Only routes that went through the link can get longer. For each device whose route to one end of the
+// link went through the other end, the devices it reached through the link (its region) are connected to that end by old
+// routes inside the region, so they are found by searching out from it. Dijkstra's algorithm is then run over just the
+// region, starting from the routes to the neighbours outside of it, which have not changed. Every new route is found from
+// the old routing tables before any of them are stored
+void repair_routes_after_slower_link(Network* self, int first_device, int second_device, int old_speed) {
+	int* first_distances = malloc((sizeof(int)) * self->vertices); // The old distance from the first device to each device
+	int* second_distances = malloc((sizeof(int)) * self->vertices); // The old distance from the second device to each device
+	int* region = malloc((sizeof(int)) * self->vertices); // The devices whose routes from the current source are found again
+	bool* in_region = malloc((sizeof(bool)) * self->vertices); // Whether each device is in the region
+	int* distances = malloc((sizeof(int)) * self->vertices); // The new distance from the current source to each device
+	int* first_hops = malloc((sizeof(int)) * self->vertices); // The new first hop from the current source to each device
+	IndexedHeap heap = create_indexed_heap(self->vertices); // The devices in the region whose distance is not final
+	RouteChange* changes = NULL; // The new routes, stored once every one has been found
+	int change_count = 0; // The number of new routes
+	int change_capacity = 0; // The number of new routes that the array has room for
+	long long largest_cost = 0; // The largest cost of a new route
+	int region_size; // The number of devices in the region
 	int current_device; // The currently assessed device
+	int neighbour_distance; // The distance from the current source to a neighbour outside of the region
+	Link* current_link;
+
+	freeze_network(self);
 
 	for (int i = 0; i < self->vertices; i++) {
-		if (i == device_index) {
+		first_distances[i] = find_table_distance(self, first_device, i);
+		second_distances[i] = find_table_distance(self, second_device, i);
+		in_region[i] = false;
+		distances[i] = INT_MAX;
+		first_hops[i] = -1;
+	}
+
+	for (int source = 0; source < self->vertices; source++) {
+		if (first_distances[source] == INT_MAX) {
 			continue;
 		}
 
-		current_device = i;
-		
-		// Backtrack to just before the parameter device. -1 check is necessary to see if device is unreachable
-		while (current_device != -1 && previous[current_device] != device_index) {
-			// If there is no valid path
-			if (previous[current_device] == -1) {
-				current_device = -1;
-			}
-			else {
-				current_device = previous[current_device];
-			}
+		// The region starts with the end of the link that the source's route reached through it
+		region_size = 0;
+		if ((long long)first_distances[source] + old_speed == second_distances[source]) {
+			region[region_size] = second_device;
+			region_size++;
+			in_region[second_device] = true;
+		}
+		if ((long long)second_distances[source] + old_speed == first_distances[source]) {
+			region[region_size] = first_device;
+			region_size++;
+			in_region[first_device] = true;
 		}
 
-		// If device can be reached
-		if (current_device != -1) {
-			self->devices[device_index].routes[i].next_hop = current_device;
-			self->devices[device_index].routes[i].cost = distances[i];
+		if (region_size == 0) {
+			continue;
 		}
-		else {
-			self->devices[device_index].routes[i].next_hop = -1;
-			self->devices[device_index].routes[i].cost = -1;
+
+		for (int i = 0; i < region_size; i++) {
+			for (int j = self->link_offsets[region[i]]; j < self->link_offsets[region[i] + 1]; j++) {
+				current_device = self->packed_links[j].to_device;
+
+				if (
+					!in_region[current_device] &&
+					is_route_through_link(self, source, current_device, first_distances, second_distances, old_speed)
+				) {
+					region[region_size] = current_device;
+					region_size++;
+					in_region[current_device] = true;
+				}
+			}
 		}
-	}
-}
 
-// Creates a routing table for each node in the network using Dijkstra's shortest path algorithm
-// Assumes that the graph has no negative weights and that it has more than 1 vertex
-// Some errors were found and troubleshooted with help from ChatGPT for this function
-void find_shortest_paths_dijkstra(Network* self, int device_index) {
-	int* distances = malloc((sizeof(int)) * self->vertices); // An array of distances
-	bool* known = malloc((sizeof(bool)) * self->vertices); // An array of visitations
-	int* previous = malloc((sizeof(int)) * self->vertices); // An array storing the previous hop of each device
-	int current_device; // The currently assessed device
-	LinkNodePtr current_link;
+		// Each device in the region starts from its shortest route through a neighbour outside of the region
+		for (int i = 0; i < region_size; i++) {
+			for (int j = self->link_offsets[region[i]]; j < self->link_offsets[region[i] + 1]; j++) {
+				current_link = &self->packed_links[j];
+				if (in_region[current_link->to_device]) {
+					continue;
+				}
+
+				neighbour_distance = find_table_distance(self, source, current_link->to_device);
+				if (neighbour_distance != INT_MAX && (long long)neighbour_distance + current_link->speed < distances[region[i]]) {
+					distances[region[i]] = neighbour_distance + current_link->speed;
+					first_hops[region[i]] = current_link->to_device == source
+						? region[i] : read_route_next_hop(self, source, current_link->to_device);
+				}
+			}
 
-	// Initialise distances
-	for (int i = 0; i < self->vertices; i++)
-	{	
-		distances[i] = INT_MAX; // Closest we can get to infinity with an INT
-		previous[i] = -1;
-		known[i] = false;
-	}
+			if (distances[region[i]] != INT_MAX) {
+				heap_push_or_decrease(&heap, region[i], distances[region[i]]);
+			}
+		}
 
-	distances[device_index] = 0;
+		while (!heap_is_empty(&heap)) {
+			current_device = heap_pop_min(&heap).device;
 
-	while (!all_devices_known(known, self->vertices)) {
-		current_device = -1; // Reset current device
+			for (int j = self->link_offsets[current_device]; j < self->link_offsets[current_device + 1]; j++) {
+				current_link = &self->packed_links[j];
 
-		// Find device with shortest distance that is still unknown and make it the current_device
-		for (int i = 0; i < self->vertices; i++)
-		{
-			// Condition makes it so that if two unknown devices have the same distance, the one that comes first in the
-			// array is assessed first
-			if (!known[i] && (current_device == -1 || distances[i] < distances[current_device])) {
-				current_device = i;
+				if (in_region[current_link->to_device] && distances[current_device] + current_link->speed < distances[current_link->to_device]) {
+					distances[current_link->to_device] = distances[current_device] + current_link->speed;
+					first_hops[current_link->to_device] = first_hops[current_device];
+					heap_push_or_decrease(&heap, current_link->to_device, distances[current_link->to_device]);
+				}
 			}
 		}
 
-		current_link = self->devices[current_device].links.head;
+		// Keep the new routes and reset the region for the next source
+		if (change_count + region_size > change_capacity) {
+			change_capacity = (change_count + region_size) * 2;
+			changes = realloc(changes, (sizeof(RouteChange)) * change_capacity);
+		}
 
-		// Traverse linked devices and overwrite paths if needed
-		while (current_link != NULL) {
-			if (
-				!known[current_link->link.to_device] && 
-				distances[current_device] + current_link->link.speed < distances[current_link->link.to_device]
-			) {
-				distances[current_link->link.to_device] = distances[current_device] + current_link->link.speed;
-				previous[current_link->link.to_device] = current_device;
+		for (int i = 0; i < region_size; i++) {
+			changes[change_count].from_device = source;
+			changes[change_count].to_device = region[i];
+			changes[change_count].route.next_hop = first_hops[region[i]];
+			changes[change_count].route.cost = distances[region[i]] != INT_MAX ? distances[region[i]] : -1;
+			change_count++;
+
+			if (distances[region[i]] != INT_MAX && distances[region[i]] > largest_cost) {
+				largest_cost = distances[region[i]];
 			}
 
-			current_link = current_link->next;
+			in_region[region[i]] = false;
+			distances[region[i]] = INT_MAX;
+			first_hops[region[i]] = -1;
 		}
+	}
 
-		known[current_device] = true;
+	if (self->route_layout != ROUTES_PER_DEVICE) {
+		widen_route_slab_costs(self, largest_cost);
 	}
 
-	build_routing_table_from_distances(self, previous, distances, device_index);
+	for (int i = 0; i < change_count; i++) {
+		set_route(self, changes[i].from_device, changes[i].to_device, changes[i].route.next_hop, changes[i].route.cost);
+	}
 
-	// Free dynamically allocated memory
+	free(first_distances);
+	free(second_distances);
+	free(region);
+	free(in_region);
 	free(distances);
-	free(known);
-	free(previous);
+	free(first_hops);
+	free(changes);
+	delete_indexed_heap(&heap);
 }
 
-// Creates a routing table for each node in the network using the Bellman-Ford shortest path algorithm
-// ChatGPT gave basic pseudocode to explain how Bellman-Ford works and was used for debugging.
-void find_shortest_paths_bellman_ford(Network* self, int device_index) {
-	typedef struct bellmanFordLinkListNode { // A link (edge) in the edge list
-		int to_device;
-		int from_device;
-		int speed;
-		struct bellmanFordLinkListNode* next;
-	} *BellmanFordLinkListPtr;
-
-	int* distances = malloc((sizeof(int)) * self->vertices); // An array of distances
-	int* previous = malloc((sizeof(int)) * self->vertices); // An array storing the previous hop of each device
-	LinkNodePtr link_to_add; // The link to add to the link list
-	BellmanFordLinkListPtr current_link = NULL; // The link that was most recently created
-	BellmanFordLinkListPtr first_link = NULL; // The first link in the edge/link list
-	BellmanFordLinkListPtr previous_link = NULL; // The link that was assessed previously
-	BellmanFordLinkListPtr new_node; // A new node to add to the list
-	
-	// Initialise distances
-	for (int i = 0; i < self->vertices; i++)
-	{
-		distances[i] = INT_MAX;
-		previous[i] = -1;
+// Sets the speed of the first link from one device to another, in one direction only. Returns the old speed, or -1 if
+// there is no link between them
+int set_link_speed(Network* self, int from_device, int to_device, int speed) {
+	LinkNodePtr current_link; // The link node currently being checked
+	int old_speed; // The speed of the link before it was changed
+
+	if (self->link_offsets != NULL) {
+		for (int i = self->link_offsets[from_device]; i < self->link_offsets[from_device + 1]; i++) {
+			if (self->packed_links[i].to_device == to_device) {
+				old_speed = self->packed_links[i].speed;
+				self->packed_links[i].speed = speed;
+				return old_speed;
+			}
+		}
+
+		return -1;
 	}
 
-	// Build list of edges
-	for (int i = 0; i < self->vertices; i++) 
-	{
-		// Check if device has any links
-		if (self->devices[i].links.head != NULL) {
-			link_to_add = self->devices[i].links.head;
-		} 
-		else {
-			link_to_add = NULL;
+	current_link = self->devices[from_device].links.head;
+	while (current_link != NULL) {
+		if (current_link->link.to_device == to_device) {
+			old_speed = current_link->link.speed;
+			current_link->link.speed = speed;
+			return old_speed;
 		}
 
-		while (link_to_add != NULL) {
-			// Create the new node
-			new_node = malloc(sizeof * new_node);
-			new_node->from_device = i;
-			new_node->to_device = link_to_add->link.to_device;
-			new_node->speed = link_to_add->link.speed;
-			new_node->next = NULL;
+		current_link = current_link->next;
+	}
 
-			// If the first link has not been used
-			if (current_link == NULL) {
-				first_link = new_node;
-				current_link = first_link;
-			}
-			else {
-				current_link->next = new_node;
-				current_link = current_link->next;
-			}
+	return -1;
+}
 
-			link_to_add = link_to_add->next;
-		}
+// Changes the speed of the link between two devices in both directions, repairing the routing tables in incremental mode.
+// Returns false if there is no link between them
+bool update_link_speed(Network* self, int first_device, int second_device, int speed) {
+	int old_speed; // The speed of the link before it was changed
+
+	first_device = to_internal_id(self, first_device);
+	second_device = to_internal_id(self, second_device);
+
+	// The packed links of a mapped file are read only
+	if (self->mapped_file.data != NULL) {
+		thaw_network(self);
 	}
 
-	distances[device_index] = 0;
+	old_speed = set_link_speed(self, first_device, second_device, speed);
+	if (old_speed == -1) {
+		return false;
+	}
+	set_link_speed(self, second_device, first_device, speed);
 
-	// Run relaxations
-	for (int i = 0; i < self->vertices - 1; i++)
-	{
-		current_link = first_link;
-		while (current_link != NULL) {
-			if (
-				distances[current_link->from_device] != INT_MAX && 
-				distances[current_link->from_device] + current_link->speed < distances[current_link->to_device]
-			) {
-				distances[current_link->to_device] = distances[current_link->from_device] + current_link->speed;
-				previous[current_link->to_device] = current_link->from_device;
-			}
+	// The edge list and packed edges have their own copy of each speed, and cached shortest path trees may no longer be
+	// shortest
+	delete_edge_list(self);
+	delete_packed_edges(self);
+	clear_route_cache(self);
 
-			current_link = current_link->next;
-		}
+	if (speed > self->max_speed) {
+		self->max_speed = speed;
 	}
 
-	// Make unreachable distances equal -1
-	for (int i = 0; i < self->vertices; i++) {
-		if (distances[i] == INT_MAX) {
-			distances[i] = -1;
+	if (self->routes_current && speed != old_speed) {
+		if (!self->incremental_routing) {
+			self->routes_current = false;
+		}
+		else if (speed < old_speed) {
+			repair_routes_after_faster_link(self, first_device, second_device, speed);
+		}
+		else {
+			repair_routes_after_slower_link(self, first_device, second_device, old_speed);
 		}
 	}
 
-	build_routing_table_from_distances(self, previous, distances, device_index);
+	return true;
+}
+
+// Removes the first link from one device to another, in one direction only. Returns the speed of the link, or -1 if there
+// is no link between them
+int remove_one_way_link(Network* self, int from_device, int to_device) {
+	LinkNodePtr current_link; // The link node currently being checked
+	LinkNodePtr previous_link = NULL; // The link node before the current one
+	int speed; // The speed of the removed link
+
+	// Removing a packed link moves every later link back by one, which is still much cheaper than thawing the network
+	if (self->link_offsets != NULL) {
+		for (int i = self->link_offsets[from_device]; i < self->link_offsets[from_device + 1]; i++) {
+			if (self->packed_links[i].to_device == to_device) {
+				speed = self->packed_links[i].speed;
+				memmove(&self->packed_links[i], &self->packed_links[i + 1], (sizeof(Link)) * (self->link_count - i - 1));
+
+				for (int j = from_device + 1; j <= self->vertices; j++) {
+					self->link_offsets[j]--;
+				}
+				self->link_count--;
+
+				return speed;
+			}
+		}
 
-	// Free memory
-	current_link = first_link;
+		return -1;
+	}
+
+	current_link = self->devices[from_device].links.head;
 	while (current_link != NULL) {
+		if (current_link->link.to_device == to_device) {
+			if (previous_link != NULL) {
+				previous_link->next = current_link->next;
+			}
+			else {
+				self->devices[from_device].links.head = current_link->next;
+			}
+
+			speed = current_link->link.speed;
+			free(current_link);
+			return speed;
+		}
+
 		previous_link = current_link;
 		current_link = current_link->next;
-		free(previous_link);
 	}
-	free(distances);
-	free(previous);
+
+	return -1;
 }
 
-// Builds a routing table for each node in the network using a specified algorithm. 0 is for Dijkstra and 1 is for Bellman-Ford
-void build_routing_tables(Network* self, int algorithm) {
-	for (int i = 0; i < self->vertices; i++)
-	{
-		if (algorithm == 0) { // 0 = Dijkstra
-			find_shortest_paths_dijkstra(self, i);
+// Removes the link between two devices in both directions, repairing the routing tables in incremental mode. Returns false
+// if there is no link between them
+bool remove_link(Network* self, int first_device, int second_device) {
+	int old_speed; // The speed of the removed link
+
+	first_device = to_internal_id(self, first_device);
+	second_device = to_internal_id(self, second_device);
+
+	// The packed links of a mapped file are read only
+	if (self->mapped_file.data != NULL) {
+		thaw_network(self);
+	}
+
+	old_speed = remove_one_way_link(self, first_device, second_device);
+	if (old_speed == -1) {
+		return false;
+	}
+	remove_one_way_link(self, second_device, first_device);
+
+	// The edge list and packed edges have their own copy of each link, cached shortest path trees may have used the link,
+	// and the link's component may have been split in two
+	delete_edge_list(self);
+	delete_packed_edges(self);
+	clear_route_cache(self);
+	delete_components(self);
+
+	if (self->routes_current) {
+		if (self->incremental_routing) {
+			repair_routes_after_slower_link(self, first_device, second_device, old_speed);
 		}
-		else if (algorithm == 1) { // 1 = Bellman-Ford
-			find_shortest_paths_bellman_ford(self, i);
-		} 
 		else {
-			printf("Error: Algorithm is not supported!");
+			self->routes_current = false;
 		}
 	}
+
+	return true;
+}
+
+// Turns incremental routing on or off
+void set_incremental_routing(Network* self, bool enabled) {
+	self->incremental_routing = enabled;
+}
+
+// Turns packed edges on or off. They are made when the routing tables are next built
+void set_edge_packing(Network* self, bool enabled) {
+	self->pack_edges = enabled;
+
+	if (!enabled) {
+		delete_packed_edges(self);
+	}
 }
 
 // Prints the routing table for a single device, or the routing table for all devices in the network if device_table_to_print = -1
@@ -303,8 +2669,8 @@ void print_routes(Network* self, int device_table_to_print) {
 	else {
 		for (int i = 0; i < self->vertices; i++)
 		{
-			next_hop = self->devices[device_table_to_print].routes[i].next_hop;
-			cost = self->devices[device_table_to_print].routes[i].cost;
+			next_hop = get_route_next_hop(self, device_table_to_print, i);
+			cost = get_route_cost(self, device_table_to_print, i);
 			printf("From device %d to device %d with a cost of %d and a next hop of %d\n", device_table_to_print, i, cost, next_hop);
 		}
 	}
@@ -331,6 +2697,9 @@ void delete_network(Network* self) {
 	LinkNodePtr link_to_free;
 
 	// Free links and routes
+	release_packed_links(self);
+	delete_edge_list(self);
+	delete_packed_edges(self);
 	for (int i = 0; i < self->vertices; i++) {
 		current_link = self->devices[i].links.head;
 		while (current_link != NULL) {	
@@ -341,6 +2710,11 @@ void delete_network(Network* self) {
 
 		free(self->devices[i].routes);
 	}
+	delete_route_slab(self);
+	delete_route_cache(self);
+	delete_components(self);
+	free(self->external_ids);
+	free(self->internal_ids);
 
 	free(self->devices);
 
@@ -348,6 +2722,88 @@ void delete_network(Network* self) {
 	self = NULL;
 }
 
+// Returns the speed of the fastest link from one device to another, or -1 if there is no link between them
+int find_link_speed(Network* self, int from_device, int to_device) {
+	LinkNodePtr current_link; // The link node currently being checked
+	int fastest = -1; // The speed of the fastest link found so far
+
+	if (self->link_offsets != NULL) {
+		for (int i = self->link_offsets[from_device]; i < self->link_offsets[from_device + 1]; i++) {
+			if (self->packed_links[i].to_device == to_device && (fastest == -1 || self->packed_links[i].speed < fastest)) {
+				fastest = self->packed_links[i].speed;
+			}
+		}
+
+		return fastest;
+	}
+
+	current_link = self->devices[from_device].links.head;
+	while (current_link != NULL) {
+		if (current_link->link.to_device == to_device && (fastest == -1 || current_link->link.speed < fastest)) {
+			fastest = current_link->link.speed;
+		}
+
+		current_link = current_link->next;
+	}
+
+	return fastest;
+}
+
+// Returns the number of routes in a network whose cost differs from the same route in another network, or whose next hop
+// is not a link that starts a route of that cost
+int count_route_differences(Network* self, Network* reference) {
+	int differences = 0; // The number of routes that differ
+	int next_hop; // The next hop of the current route
+	int cost; // The cost of the current route
+
+	for (int i = 0; i < self->vertices; i++) {
+		for (int j = 0; j < self->vertices; j++) {
+			next_hop = get_route_next_hop(self, i, j);
+			cost = get_route_cost(self, i, j);
+
+			if (cost != get_route_cost(reference, i, j)) {
+				differences++;
+			}
+			else if (
+				next_hop != -1 &&
+				(long long)find_link_speed(self, to_internal_id(self, i), to_internal_id(self, next_hop)) +
+					find_table_distance(self, to_internal_id(self, next_hop), to_internal_id(self, j)) != cost
+			) {
+				differences++;
+			}
+		}
+	}
+
+	return differences;
+}
+
+// Makes a set of link changes to a network for testing incremental routing. Every third change adds a link across the
+// network, and the others make a link of the given devices faster or slower
+void change_test_links(Network* self, int* neighbours, int change_count) {
+	int device_index; // The device whose link is changed
+
+	for (int i = 0; i < change_count; i++) {
+		device_index = i * 37 % self->vertices;
+
+		if (i % 3 == 0) {
+			add_link(self, device_index, (device_index + self->vertices / 2) % self->vertices, 1 + i % 4);
+		}
+		else if (i % 3 == 1) {
+			update_link_speed(self, device_index, neighbours[i], 1);
+		}
+		else {
+			update_link_speed(self, device_index, neighbours[i], 200);
+		}
+	}
+}
+
+// Removes a link from each of the given devices for testing incremental routing
+void remove_test_links(Network* self, int* neighbours, int change_count) {
+	for (int i = 0; i < change_count; i++) {
+		remove_link(self, i * 37 % self->vertices, neighbours[i]);
+	}
+}
+
 // Tests all functions in this file
 void test_network() {
 	// Note about testing build_routing_tables: This function is simply a wrapper function that calls an algorithm function in a loop.
@@ -373,8 +2829,33 @@ void test_network() {
 	FILE* routing_table_file = fopen(ROUTING_TABLE_FILE_PATH, "r"); // The file containing the routing table that corresponds to the test network
 	Network* testing_network;	// The network used for testing this file
 	Network* empty_network;		// An initially empty network
+	Network* heap_network;		// A network used for testing the heap and bucket queue versions of Dijkstra's algorithm
+	Network* slow_network;		// A network with a link that is too slow for the bucket queue
+	Network* packed_network;	// A network used for testing freezing and thawing
+	Network* parallel_network;	// A network whose routing tables are built with several threads
+	Network* compact_network;	// A network whose routing tables are stored in the route slab
+	Network* wide_network;		// A network whose route slab costs have to be widened
+	Network* symmetric_network;	// A network whose routing tables are stored in the symmetric layout
+	Network* repaired_network;	// A network whose routing tables are repaired as its links change
+	Network* rebuilt_network;	// A network whose routing tables are built again after its links change
+	Network* island_network;	// A network that is split into several components
+	Network* reordered_network;	// A network whose devices have been renumbered
+	Network* packed_edge_network;	// A network whose links are packed into 32-bit words
+	Network* matrix_network;	// A network whose routing tables are built with Floyd-Warshall
+	Network* planned_network;	// A network whose routing algorithm is chosen automatically
+	Network* counted_network;	// A network whose routing work is counted
+	RoutingCounters counters;	// The routing counters of the counted network
+	long long histogram_total;	// The number of searches in each histogram of the counted network
+	const String PLANNED_FILE_PATHS[] = {
+		"devices_100_avgdegree_10.0_large_network.txt",
+		"devices_1000_avgdegree_10.0_large_network.txt",
+		"devices_1000_avgdegree_2.0_large_network.txt"
+	}; // The networks to choose routing algorithms for
+	int changed_neighbours[30];	// The neighbour of each device whose link speed is changed when testing incremental routing
+	int differences;			// The number of routes that differ between two networks
+	char* parse_buffer;			// A buffer of text to parse integers from
+	char* parse_cursor;			// The next character to parse in the buffer
 	bool* known = malloc((sizeof(bool)) * KNOWN_ARRAY_SIZE); // An array of visitations
-	LinkNodePtr current_link_node; // The link node currently being iterated over
 
 
 	// Testing network values
@@ -391,6 +2872,7 @@ void test_network() {
 	Network* distance_table_network;
 	int* distances;
 	int* previous;
+	int* first_hops;
 
 
 	printf("\n------------------------------------------------------\n                  *network.c tests*\n");
@@ -400,15 +2882,9 @@ void test_network() {
 	// ----------------------------------------------------------------------------------------------------------------
 	printf("----------------\n1. add_link() test\n----------------\n");
 
-	// 1.1 - Test whether the function can add an link to the network, and that the link is added in reverse. This function 
-	//		 has no alternative execution paths and therefore only requires this test
-	empty_network = malloc(sizeof * empty_network);
-	empty_network->vertices = 3;
-
-	empty_network->devices = malloc((sizeof * empty_network->devices) * empty_network->vertices);
-
-	empty_network->devices[0].links.head = NULL;
-	empty_network->devices[1].links.head = NULL;
+	// 1.1 - Test whether the function can add an link to the network, and that the link is added in reverse. Also tests that
+	//		 the largest speed in the network is raised to the speed of the new link
+	empty_network = create_network(3);
 
 	add_link(empty_network, 0, 1, 2);
 
@@ -416,6 +2892,8 @@ void test_network() {
 	printf("Link from device 0 to device %d with speed %d", empty_network->devices[0].links.head->link.to_device, empty_network->devices[0].links.head->link.speed);
 	printf("\n1.1 - Expected Result: Link from device 1 to device 0 with speed 2\n1.1 - Actual Result: ");
 	printf("Link from device 1 to device %d with speed %d", empty_network->devices[1].links.head->link.to_device, empty_network->devices[1].links.head->link.speed);
+	printf("\n1.1 - Expected Result: Largest speed of 2\n1.1 - Actual Result: ");
+	printf("Largest speed of %d", empty_network->max_speed);
 
 	// ----------------------------------------------------------------------------------------------------------------
 	// 2 - Test build_network_from_file()
@@ -427,8 +2905,8 @@ void test_network() {
 	printf("2.1 - Actual Result: ");
 	build_network_from_file("meow.txt");
 
-	// 2.2 - Test when the filepath is valid. This builds the network and returns it. This function has no other execution paths
-	//       so this test is sufficient to test it.
+	// 2.2 - Test when the filepath is valid. This builds the network and returns it frozen, so its links are read from the
+	//		 packed arrays. Each device's links should be in the reverse of the order they are in the file
 	testing_network = build_network_from_file(TEST_FILE_PATH);
 
 	// Skip the first line
@@ -443,14 +2921,38 @@ void test_network() {
 
 	printf("2.2 - Actual Result:\n");
 	for (int i = 0; i < testing_network->vertices; i++) {
-		current_link_node = testing_network->devices[i].links.head;
-		while (current_link_node != NULL) {
-			printf("Link between %d and %d with weight of %d\n", i, current_link_node->link.to_device, current_link_node->link.speed);
-			current_link_node = current_link_node->next;
+		for (int j = testing_network->link_offsets[i]; j < testing_network->link_offsets[i + 1]; j++) {
+			printf("Link between %d and %d with weight of %d\n", i, testing_network->packed_links[j].to_device, testing_network->packed_links[j].speed);
 		}
 	}
 	printf("end of network\n");
 
+	// 2.3 - Test parse_next_int() on a buffer with a negative integer and a character that is not part of an integer. The
+	//		 cursor should not move when no integer is found, leaving the newline and the x
+	parse_buffer = "  12,-3\nx";
+	parse_cursor = parse_buffer;
+
+	printf("2.3 - Expected Result: 12 -3, 2 characters left\n2.3 - Actual Result:");
+	while (parse_next_int(&parse_cursor, parse_buffer + strlen(parse_buffer), &speed)) {
+		printf(" %d", speed);
+	}
+	printf(", %d characters left\n", (int)strlen(parse_cursor));
+
+	// 2.4 - Test parse_next_int() on an integer too large for an int. Parsing should stop there without moving the cursor
+	parse_buffer = "7 99999999999 8";
+	parse_cursor = parse_buffer;
+
+	printf("2.4 - Expected Result: 7, 14 characters left\n2.4 - Actual Result:");
+	while (parse_next_int(&parse_cursor, parse_buffer + strlen(parse_buffer), &speed)) {
+		printf(" %d", speed);
+	}
+	printf(", %d characters left\n", (int)strlen(parse_cursor));
+
+	// 2.5 - Test when the file has a link to a device that is not in the network. The routing table file starts with a
+	//		 device count of 0, so its first route is read as a link from device 0
+	printf("2.5 - Expected Result: Error: Link between devices that are not in the network!\n2.5 - Actual Result: ");
+	build_network_from_file(ROUTING_TABLE_FILE_PATH);
+
 	// ----------------------------------------------------------------------------------------------------------------
 	// 3 - Test all_devices_known()
 	// ----------------------------------------------------------------------------------------------------------------
@@ -494,7 +2996,8 @@ void test_network() {
 	printf("----------------\n4. build_routing_table_from_distances() test\n----------------\n");
 
 	// 4.1 - Test whether the function can generate a routing table for the network when there are no unreachable nodes.
-	//		 This tests all loops, the first else statement and the second if statement within the inner while loop. 
+	//		 This tests all loops, and finding first hops both from a device linked to the source device and from a device
+	//		 whose first hop is already known
 	distance_table_network = build_network_from_file(TEST_FILE_PATH);
 	distances = malloc((sizeof(int)) * distance_table_network->vertices);
 	previous = malloc((sizeof(int)) * distance_table_network->vertices);
@@ -520,7 +3023,7 @@ void test_network() {
 	print_routes(distance_table_network, 0);
 
 	// 4.2 - Test whether the function can generate a routing table for the network when there are unreachable nodes.
-	//		 This tests all loops, the first if statement and the second else statement within the inner while loop. 
+	//		 This tests the else statement for devices with no valid path. 
 
 	// Remove link from 1 to 2, making it unreachable
 	distances[1] = -1;
@@ -532,7 +3035,34 @@ void test_network() {
 	printf("From device 0 to device 1 with a cost of -1 and a next hop of -1");
 
 	printf("\n4.2 - Actual Result:\n");
-	printf("From device 0 to device 1 with a cost of %d and a next hop of %d\n", testing_network->devices[0].routes[1].cost, testing_network->devices[0].routes[1].next_hop);
+	printf("From device 0 to device 1 with a cost of %d and a next hop of %d\n", get_route_cost(testing_network, 0, 1), get_route_next_hop(testing_network, 0, 1));
+
+	// 4.3 - Test build_routing_table_from_first_hops(), which the other algorithms use directly. Device 4 is given a first
+	//		 hop of 3 and device 1 is left unreachable. This tests both the if and else statements
+	first_hops = malloc((sizeof(int)) * distance_table_network->vertices);
+	for (int i = 0; i < distance_table_network->vertices; i++) {
+		first_hops[i] = -1;
+	}
+	first_hops[4] = 3;
+
+	build_routing_table_from_first_hops(distance_table_network, first_hops, distances, 0);
+
+	printf("4.3 - Expected Result:\n");
+	printf("From device 0 to device 1 with a cost of -1 and a next hop of -1\n");
+	printf("From device 0 to device 4 with a cost of 4 and a next hop of 3\n");
+
+	printf("4.3 - Actual Result:\n");
+	printf(
+		"From device 0 to device 1 with a cost of %d and a next hop of %d\n",
+		distance_table_network->devices[0].routes[1].cost,
+		distance_table_network->devices[0].routes[1].next_hop
+	);
+	printf(
+		"From device 0 to device 4 with a cost of %d and a next hop of %d\n",
+		distance_table_network->devices[0].routes[4].cost,
+		distance_table_network->devices[0].routes[4].next_hop
+	);
+
 
 
 	// ----------------------------------------------------------------------------------------------------------------
@@ -556,7 +3086,9 @@ void test_network() {
 
 	// 5.2 - Test when the graph has an unreachable node. This triggers the if statement within the final while statement 
 	//       that checks if the device has no path to it. Also triggers the final else statement within the final while statement.
-	//       This test and the test above together execute all code paths
+	//       This test and the test above together execute all code paths. The network is thawed so that links can be
+	//		 removed from the lists directly
+	thaw_network(testing_network);
 	free(testing_network->devices[0].links.head);
 	testing_network->devices[0].links.head = NULL;
 
@@ -600,19 +3132,6 @@ void test_network() {
 	// 5.4 - Test when the network has a cycle in it with each link/edge in the cycle having the same weight. A cycle 
 	//		 should not break Dijkstra's algorithm as it can handle them and it should not cause in infinite loop in 
 	//       the code.
-	empty_network->devices[2].links.head = NULL;
-	empty_network->devices[0].routes = malloc((sizeof * empty_network->devices[0].routes) * empty_network->vertices);
-	empty_network->devices[1].routes = malloc((sizeof * empty_network->devices[1].routes) * empty_network->vertices);
-	empty_network->devices[2].routes = malloc((sizeof * empty_network->devices[2].routes) * empty_network->vertices);
-	for (int i = 0; i < empty_network->vertices; i++)
-	{
-		for (int j = 0; j < empty_network->vertices; j++)
-		{
-			empty_network->devices[i].routes[j].cost = -1;
-			empty_network->devices[i].routes[j].next_hop = -1;
-		}
-	}
-
 	add_link(empty_network, 0, 2, 2);
 	add_link(empty_network, 1, 2, 2);
 	find_shortest_paths_dijkstra(empty_network, 0);
@@ -662,6 +3181,7 @@ void test_network() {
 	// 6.2 - Test when the graph has an unreachable node. This triggers the first else statment of the function. 
 	//		  This test and the test above together execute all code paths
 
+	thaw_network(testing_network);
 	free(testing_network->devices[0].links.head);
 	testing_network->devices[0].links.head = NULL;
 
@@ -732,61 +3252,918 @@ void test_network() {
 	printf("6.4 - Actual Result:\n");
 	print_routes(empty_network, -1);
 
-	// Free memory
-	free(known);
-	free(distances);
-	free(previous);
-	delete_network(empty_network);
-	delete_network(testing_network);
-	delete_network(distance_table_network);
-}
+	// ----------------------------------------------------------------------------------------------------------------
+	// 7 - Test find_shortest_paths_dijkstra_heap()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n7. find_shortest_paths_dijkstra_heap() test\n----------------\n");
 
-void compare_algorithms() {
-	clock_t start;		// The starting time
-	clock_t difference; // The time between the start and the end
-	long milliseconds;  // How long in milliseconds the difference is
-	Network* test_network; // The network to use for comapring the two algorithms
-	int device_counts[] = { 10, 100, 500, 1000 };  // The different device counts that the test files have
-	float avg_degrees[] = { 1.0, 2.0, 5.0, 10.0 };			 // The different average degrees that the test files have
-	String filename_template = "devices_%d_avgdegree_%.1f_large_network.txt"; // The template of the filename for each test network
+	// 7.1 - Test whether the function can correctly create a routing table from a network. This tests all loops in the
+	//       function and the if statement that overwrites paths. The network is rebuilt as the testing network had links
+	//       removed in 5.2 and 6.2
+	heap_network = build_network_from_file(TEST_FILE_PATH);
+	find_shortest_paths_dijkstra_heap(heap_network, 3);
 
-	char buffer[50]; // A buffer to hold the formatted filename
+	printf("7.1 - Expected Result:\n");
+	print_routes_from_test_file(routing_table_file, heap_network->vertices);
 
-	// Loop over device counts
-	for (int device_count = 0; device_count < 4; device_count++)
-	{
-		// Loop over average degrees
-		for (int avg_degree = 0; avg_degree < 4; avg_degree++)
-		{
-			// A test file with these values does not exist
-			if (device_counts[device_count] == 10 && avg_degrees[avg_degree] == 10.0) {
-				continue;
+	printf("7.1 - Actual Result:\n");
+	print_routes(heap_network, 3);
+
+	// 7.2 - Test when the graph has an unreachable node. Device 0 lost all of its links in 6.2, so it should never be
+	//		 pushed onto the heap and the search should stop once the heap is empty
+	find_shortest_paths_dijkstra_heap(testing_network, 0);
+	find_shortest_paths_dijkstra_heap(testing_network, 3);
+
+	printf("7.2 - Expected Result:\n");
+	printf("From device 0 to device 3 with a cost of -1 and a next hop of -1\n");
+	printf("From device 3 to device 0 with a cost of -1 and a next hop of -1\n");
+
+	printf("7.2 - Actual Result:\n");
+	printf(
+		"From device 0 to device 3 with a cost of %d and a next hop of %d\n",
+		testing_network->devices[0].routes[3].cost,
+		testing_network->devices[0].routes[3].next_hop
+	);
+	printf(
+		"From device 3 to device 0 with a cost of %d and a next hop of %d\n",
+		testing_network->devices[3].routes[0].cost,
+		testing_network->devices[3].routes[0].next_hop
+	);
+
+	// 7.3 - Test when two paths exist to the same device. 4 is first reached directly from 1 with a cost of 8 and must
+	//		 then have its priority decreased when it is reached through 2 with a cost of 6
+	find_shortest_paths_dijkstra_heap(testing_network, 1);
+
+	printf("7.3 - Expected Result: From device 1 to device 4 with a cost of 6 and a next hop of 2\n");
+	printf(
+		"7.3 - Actual Result: From device 1 to device 4 with a cost of %d and a next hop of %d\n",
+		testing_network->devices[1].routes[4].cost,
+		testing_network->devices[1].routes[4].next_hop
+	);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 8 - Test find_shortest_paths_dijkstra_buckets()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n8. find_shortest_paths_dijkstra_buckets() test\n----------------\n");
+
+	// 8.1 - Test whether the function can correctly create a routing table from a network. This tests all loops in the
+	//       function and the if statement that overwrites paths, but not the fallback to the heap version
+	find_shortest_paths_dijkstra_buckets(heap_network, 4);
+
+	printf("8.1 - Expected Result:\n");
+	print_routes_from_test_file(routing_table_file, heap_network->vertices);
+
+	printf("8.1 - Actual Result:\n");
+	print_routes(heap_network, 4);
+
+	// 8.2 - Test when two paths exist to the same device. 4 is first put in the bucket for 8 and must then be moved to
+	//		 the bucket for 6
+	find_shortest_paths_dijkstra_buckets(testing_network, 1);
+
+	printf("8.2 - Expected Result: From device 1 to device 4 with a cost of 6 and a next hop of 2\n");
+	printf(
+		"8.2 - Actual Result: From device 1 to device 4 with a cost of %d and a next hop of %d\n",
+		testing_network->devices[1].routes[4].cost,
+		testing_network->devices[1].routes[4].next_hop
+	);
+
+	// 8.3 - Test when the network has a link that is slower than the bucket queue allows. This triggers the fallback to
+	//		 the heap version, which should still find the route
+	slow_network = create_network(2);
+	add_link(slow_network, 0, 1, BUCKET_QUEUE_MAX_SPEED + 1);
+	find_shortest_paths_dijkstra_buckets(slow_network, 0);
+
+	printf("8.3 - Expected Result: From device 0 to device 1 with a cost of %d and a next hop of 1\n", BUCKET_QUEUE_MAX_SPEED + 1);
+	printf(
+		"8.3 - Actual Result: From device 0 to device 1 with a cost of %d and a next hop of %d\n",
+		slow_network->devices[0].routes[1].cost,
+		slow_network->devices[0].routes[1].next_hop
+	);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 9 - Test freeze_network() and thaw_network()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n9. freeze_network() and thaw_network() test\n----------------\n");
+
+	// 9.1 - Test freezing a network. Each device's links should be packed in list order (newest first), the offsets should
+	//		 mark where each device's links start and the lists should be emptied
+	packed_network = create_network(3);
+	add_link(packed_network, 0, 1, 4);
+	add_link(packed_network, 0, 2, 8);
+	freeze_network(packed_network);
+
+	printf("9.1 - Expected Result: offsets 0 2 3 4, links 2(8) 1(4) 0(4) 0(8), lists empty\n9.1 - Actual Result: offsets");
+	for (int i = 0; i <= packed_network->vertices; i++) {
+		printf(" %d", packed_network->link_offsets[i]);
+	}
+	printf(", links");
+	for (int i = 0; i < packed_network->link_count; i++) {
+		printf(" %d(%d)", packed_network->packed_links[i].to_device, packed_network->packed_links[i].speed);
+	}
+	printf(", lists %s\n", packed_network->devices[0].links.head == NULL ? "empty" : "not empty");
+
+	// 9.2 - Test freezing a network that is already frozen. The packed arrays should not be rebuilt
+	printf("9.2 - Expected Result: 4 links\n9.2 - Actual Result: ");
+	freeze_network(packed_network);
+	printf("%d links\n", packed_network->link_count);
+
+	// 9.3 - Test thawing a network, which is also done by adding a link to a frozen network. The existing links should be
+	//		 back in their lists in the same order, behind the new link
+	add_link(packed_network, 0, 1, 1);
+
+	printf("9.3 - Expected Result: packed arrays freed, device 0 links 1(1) 2(8) 1(4)\n9.3 - Actual Result: ");
+	printf("packed arrays %s, device 0 links", packed_network->link_offsets == NULL ? "freed" : "not freed");
+	for (LinkNodePtr current = packed_network->devices[0].links.head; current != NULL; current = current->next) {
+		printf(" %d(%d)", current->link.to_device, current->link.speed);
+	}
+	printf("\n");
+
+	// 9.4 - Test thawing a network that is not frozen. The lists should not change
+	thaw_network(packed_network);
+
+	printf("9.4 - Expected Result: device 0 first link 1(1)\n9.4 - Actual Result: ");
+	printf(
+		"device 0 first link %d(%d)\n",
+		packed_network->devices[0].links.head->link.to_device,
+		packed_network->devices[0].links.head->link.speed
+	);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 10 - Test build_routing_tables_parallel()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n10. build_routing_tables_parallel() test\n----------------\n");
+
+	// 10.1 - Test that building the tables with several threads gives the same tables as building them with one. This
+	//		  runs the parallel loop with a working memory for each thread
+	parallel_network = build_network_from_file(TEST_FILE_PATH);
+	build_routing_tables(heap_network, ALGORITHM_DIJKSTRA_HEAP);
+	build_routing_tables_parallel(parallel_network, ALGORITHM_DIJKSTRA_HEAP, 4);
+
+	differences = 0;
+	for (int i = 0; i < parallel_network->vertices; i++) {
+		for (int j = 0; j < parallel_network->vertices; j++) {
+			if (
+				parallel_network->devices[i].routes[j].cost != heap_network->devices[i].routes[j].cost ||
+				parallel_network->devices[i].routes[j].next_hop != heap_network->devices[i].routes[j].next_hop
+			) {
+				differences++;
 			}
+		}
+	}
 
-			snprintf(
-				buffer,
-				sizeof(buffer),
-				filename_template,
-				device_counts[device_count],
-				avg_degrees[avg_degree]
-			);
-			test_network = build_network_from_file(buffer);
+	printf("10.1 - Expected Result: 0 routes differ\n10.1 - Actual Result: %d routes differ\n", differences);
+
+	// 10.2 - Test when the algorithm is not supported. No routing tables should be built
+	printf("10.2 - Expected Result: Error: Algorithm is not supported!\n10.2 - Actual Result: ");
+	build_routing_tables_parallel(parallel_network, -2, 0);
+	printf("\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 11 - Test build_edge_list() and delete_edge_list()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n11. build_edge_list() and delete_edge_list() test\n----------------\n");
+
+	// 11.1 - Test building the edge list of a frozen network. The edges should be in the same order as the packed links
+	build_edge_list(parallel_network);
+
+	printf("11.1 - Expected Result:\n");
+	for (int i = 0; i < parallel_network->vertices; i++) {
+		for (int j = parallel_network->link_offsets[i]; j < parallel_network->link_offsets[i + 1]; j++) {
+			printf("%d->%d (%d) ", i, parallel_network->packed_links[j].to_device, parallel_network->packed_links[j].speed);
+		}
+	}
+	printf("\n11.1 - Actual Result:\n");
+	for (int i = 0; i < parallel_network->edges.count; i++) {
+		printf(
+			"%d->%d (%d) ",
+			parallel_network->edges.from_devices[i],
+			parallel_network->edges.to_devices[i],
+			parallel_network->edges.speeds[i]
+		);
+	}
+	printf("\n");
+
+	// 11.2 - Test that thawing the network deletes the edge list, as it would be out of date once links are added
+	thaw_network(parallel_network);
+
+	printf("11.2 - Expected Result: edge list deleted\n11.2 - Actual Result: ");
+	printf("edge list %s\n", parallel_network->edges.from_devices == NULL ? "deleted" : "not deleted");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 12 - Test find_shortest_paths_spfa()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n12. find_shortest_paths_spfa() test\n----------------\n");
+
+	// 12.1 - Test whether the function can correctly create a routing table from a network. Device 4 is relaxed from 2
+	//		  once 2 is taken from the queue. This tests all loops and the if statements that overwrite paths and queue devices
+	find_shortest_paths_spfa(heap_network, 0);
+
+	printf("12.1 - Expected Result:\n");
+	printf("From device 0 to device 0 with a cost of -1 and a next hop of -1\n");
+	printf("From device 0 to device 1 with a cost of 6 and a next hop of 3\n");
+	printf("From device 0 to device 2 with a cost of 2 and a next hop of 3\n");
+	printf("From device 0 to device 3 with a cost of 1 and a next hop of 3\n");
+	printf("From device 0 to device 4 with a cost of 4 and a next hop of 3\n");
+
+	printf("12.1 - Actual Result:\n");
+	print_routes(heap_network, 0);
+
+	// 12.2 - Test when a device's distance is shortened while it is already in the queue. 4 is queued from 1 with a cost of 8,
+	//		  then shortened to 6 through 2 before it leaves the queue, so it must not be queued a second time
+	find_shortest_paths_spfa(testing_network, 1);
+
+	printf("12.2 - Expected Result: From device 1 to device 4 with a cost of 6 and a next hop of 2\n");
+	printf(
+		"12.2 - Actual Result: From device 1 to device 4 with a cost of %d and a next hop of %d\n",
+		testing_network->devices[1].routes[4].cost,
+		testing_network->devices[1].routes[4].next_hop
+	);
+
+	// 12.3 - Test when the network has a negative cycle. A negative link can be crossed back and forth forever, so the
+	//		  function must give up rather than loop forever
+	add_link(slow_network, 0, 1, -1);
+	find_shortest_paths_spfa(slow_network, 0);
+
+	printf("12.3 - Expected Result: Function returns\n12.3 - Actual Result: Function returns\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 13 - Test set_route_layout(), get_route_next_hop() and get_route_cost()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n13. set_route_layout() test\n----------------\n");
+
+	// 13.1 - Test building the routing tables into the route slab. The routes should be the same as with each device
+	//		  having its own routes
+	compact_network = build_network_from_file(TEST_FILE_PATH);
+	set_route_layout(compact_network, ROUTES_COMPACT);
+	build_routing_tables(compact_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("13.1 - Expected Result:\n");
+	printf("From device 0 to device 0 with a cost of -1 and a next hop of -1\n");
+	printf("From device 0 to device 1 with a cost of 6 and a next hop of 3\n");
+	printf("From device 0 to device 2 with a cost of 2 and a next hop of 3\n");
+	printf("From device 0 to device 3 with a cost of 1 and a next hop of 3\n");
+	printf("From device 0 to device 4 with a cost of 4 and a next hop of 3\n");
+
+	printf("13.1 - Actual Result:\n");
+	print_routes(compact_network, 0);
+
+	// 13.2 - Test the widths chosen for the slab. 5 devices and routes costing at most 2 * 6 both fit in one byte, and
+	//		  the devices should not have their own routes
+	printf("13.2 - Expected Result: 1 byte next hops, 1 byte costs, device routes NULL\n13.2 - Actual Result: ");
+	printf(
+		"%d byte next hops, %d byte costs, device routes %s\n",
+		compact_network->route_slab.next_hop_bytes,
+		compact_network->route_slab.cost_bytes,
+		compact_network->devices[0].routes == NULL ? "NULL" : "not NULL"
+	);
+
+	// 13.3 - Test changing back to each device having its own routes. The routes should be copied and the slab freed
+	set_route_layout(compact_network, ROUTES_PER_DEVICE);
 
-			start = clock();
-			build_routing_tables(test_network, 0);
-			difference = clock() - start;
-			milliseconds = difference * 1000 / CLOCKS_PER_SEC;
+	printf("13.3 - Expected Result: From device 1 to device 4 with a cost of 6 and a next hop of 2, slab freed\n");
+	printf(
+		"13.3 - Actual Result: From device 1 to device 4 with a cost of %d and a next hop of %d, slab %s\n",
+		compact_network->devices[1].routes[4].cost,
+		compact_network->devices[1].routes[4].next_hop,
+		compact_network->route_slab.costs == NULL ? "freed" : "not freed"
+	);
+
+	// 13.4 - Test adding a link that makes routes cost more than the slab's costs can hold. The costs should be widened
+	//		  to two bytes when the tables are next built
+	wide_network = create_network(3);
+	add_link(wide_network, 0, 1, 100);
+	set_route_layout(wide_network, ROUTES_COMPACT);
+	build_routing_tables(wide_network, ALGORITHM_DIJKSTRA_HEAP);
+	add_link(wide_network, 1, 2, 1000);
+	build_routing_tables(wide_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("13.4 - Expected Result: 2 byte costs, from device 0 to device 2 with a cost of 1100\n13.4 - Actual Result: ");
+	printf(
+		"%d byte costs, from device 0 to device 2 with a cost of %d\n",
+		wide_network->route_slab.cost_bytes,
+		get_route_cost(wide_network, 0, 2)
+	);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 14 - Test building routing tables in the symmetric layout
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n14. Symmetric route layout test\n----------------\n");
+
+	// 14.1 - Test that the routes back to earlier devices are filled in from their searches. Device 4 is last, so it is
+	//		  never searched from and every one of its routes comes from the device it goes to
+	symmetric_network = build_network_from_file(TEST_FILE_PATH);
+	set_route_layout(symmetric_network, ROUTES_SYMMETRIC);
+	build_routing_tables(symmetric_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("14.1 - Expected Result:\n");
+	printf("From device 4 to device 0 with a cost of 4 and a next hop of 2\n");
+	printf("From device 4 to device 1 with a cost of 6 and a next hop of 2\n");
+	printf("From device 4 to device 2 with a cost of 2 and a next hop of 2\n");
+	printf("From device 4 to device 3 with a cost of 3 and a next hop of 2\n");
+	printf("From device 4 to device 4 with a cost of -1 and a next hop of -1\n");
+
+	printf("14.1 - Actual Result:\n");
+	print_routes(symmetric_network, 4);
+
+	// 14.2 - Test that every cost is the same as when each device's routes are found with its own search
+	differences = 0;
+	for (int i = 0; i < symmetric_network->vertices; i++) {
+		for (int j = 0; j < symmetric_network->vertices; j++) {
+			if (get_route_cost(symmetric_network, i, j) != get_route_cost(compact_network, i, j)) {
+				differences++;
+			}
+		}
+	}
+
+	printf("14.2 - Expected Result: 0 costs differ\n14.2 - Actual Result: %d costs differ\n", differences);
+
+	// 14.3 - Test finding the routes of a single device. Both its routes and the routes back to it should be filled in,
+	//		  including the routes to the devices before it
+	delete_network(symmetric_network);
+	symmetric_network = build_network_from_file(TEST_FILE_PATH);
+	set_route_layout(symmetric_network, ROUTES_SYMMETRIC);
+	find_shortest_paths_dijkstra_heap(symmetric_network, 2);
+
+	printf("14.3 - Expected Result: From device 2 to device 0 with a cost of 2 and a next hop of 3, ");
+	printf("from device 0 to device 2 with a cost of 2 and a next hop of 3\n");
+	printf(
+		"14.3 - Actual Result: From device 2 to device 0 with a cost of %d and a next hop of %d, ",
+		get_route_cost(symmetric_network, 2, 0),
+		get_route_next_hop(symmetric_network, 2, 0)
+	);
+	printf(
+		"from device 0 to device 2 with a cost of %d and a next hop of %d\n",
+		get_route_cost(symmetric_network, 0, 2),
+		get_route_next_hop(symmetric_network, 0, 2)
+	);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 15 - Test incremental routing
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n15. Incremental routing test\n----------------\n");
+
+	// 15.1 - Test adding a link when incremental routing is off. The routing tables should be marked as out of date
+	repaired_network = build_network_from_file(TEST_FILE_PATH);
+	build_routing_tables(repaired_network, ALGORITHM_DIJKSTRA_HEAP);
+	add_link(repaired_network, 0, 1, 1);
+
+	printf("15.1 - Expected Result: Routes out of date\n15.1 - Actual Result: ");
+	printf("Routes %s\n", repaired_network->routes_current ? "up to date" : "out of date");
+
+	// 15.2 - Test adding a link when incremental routing is on. The route from device 4 to device 1 used to go through
+	//		  device 2, and should now go through devices 2, 3 and 0 and the new link. The route back should start with
+	//		  the new link
+	delete_network(repaired_network);
+	repaired_network = build_network_from_file(TEST_FILE_PATH);
+	build_routing_tables(repaired_network, ALGORITHM_DIJKSTRA_HEAP);
+	set_incremental_routing(repaired_network, true);
+	add_link(repaired_network, 0, 1, 1);
+
+	printf("15.2 - Expected Result:\n");
+	printf("From device 4 to device 1 with a cost of 5 and a next hop of 2\n");
+	printf("From device 1 to device 4 with a cost of 5 and a next hop of 0\n");
+	printf("From device 0 to device 1 with a cost of 1 and a next hop of 1\n");
+	printf("15.2 - Actual Result:\n");
+	printf(
+		"From device 4 to device 1 with a cost of %d and a next hop of %d\n",
+		get_route_cost(repaired_network, 4, 1),
+		get_route_next_hop(repaired_network, 4, 1)
+	);
+	printf(
+		"From device 1 to device 4 with a cost of %d and a next hop of %d\n",
+		get_route_cost(repaired_network, 1, 4),
+		get_route_next_hop(repaired_network, 1, 4)
+	);
+	printf(
+		"From device 0 to device 1 with a cost of %d and a next hop of %d\n",
+		get_route_cost(repaired_network, 0, 1),
+		get_route_next_hop(repaired_network, 0, 1)
+	);
+
+	// 15.3 - Test changing the speed of a link that does not exist
+	printf("15.3 - Expected Result: Link not found\n15.3 - Actual Result: ");
+	printf("Link %s\n", update_link_speed(repaired_network, 1, 4, 3) ? "found" : "not found");
+
+	// 15.4 - Test a series of added, faster and slower links on a larger network in each route layout. The repaired
+	//		  routing tables should match routing tables built again after the changes
+	printf("15.4 - Expected Result: 0, 0 and 0 routes differ\n15.4 - Actual Result: ");
+	delete_network(repaired_network);
+	repaired_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+	for (int i = 0; i < 30; i++) {
+		first_device = i * 37 % repaired_network->vertices;
+		changed_neighbours[i] = repaired_network->link_offsets[first_device + 1] > repaired_network->link_offsets[first_device]
+			? repaired_network->packed_links[repaired_network->link_offsets[first_device]].to_device : -1;
+	}
+
+	for (int layout = ROUTES_PER_DEVICE; layout <= ROUTES_SYMMETRIC; layout++) {
+		delete_network(repaired_network);
+		repaired_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+		set_route_layout(repaired_network, layout);
+		build_routing_tables(repaired_network, ALGORITHM_DIJKSTRA_HEAP);
+		set_incremental_routing(repaired_network, true);
+		change_test_links(repaired_network, changed_neighbours, 30);
+
+		rebuilt_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+		change_test_links(rebuilt_network, changed_neighbours, 30);
+		build_routing_tables(rebuilt_network, ALGORITHM_DIJKSTRA_HEAP);
+
+		printf(
+			layout == ROUTES_PER_DEVICE ? "%d" : layout == ROUTES_COMPACT ? ", %d" : " and %d",
+			count_route_differences(repaired_network, rebuilt_network)
+		);
+		delete_network(rebuilt_network);
+	}
+	printf(" routes differ\n");
 
-			printf("Dijkstra's algorithm  -  %d devices & %.1f average degrees: %d ms\n", device_counts[device_count], avg_degrees[avg_degree], milliseconds);
+	// ----------------------------------------------------------------------------------------------------------------
+	// 16 - Test remove_link()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n16. remove_link() test\n----------------\n");
+
+	// 16.1 - Test removing a link that does not exist
+	delete_network(repaired_network);
+	repaired_network = build_network_from_file(TEST_FILE_PATH);
+
+	printf("16.1 - Expected Result: Link not found\n16.1 - Actual Result: ");
+	printf("Link %s\n", remove_link(repaired_network, 0, 4) ? "found" : "not found");
+
+	// 16.2 - Test removing a link when incremental routing is off. The routing tables should be marked as out of date
+	build_routing_tables(repaired_network, ALGORITHM_DIJKSTRA_HEAP);
+	remove_link(repaired_network, 2, 4);
+
+	printf("16.2 - Expected Result: Routes out of date\n16.2 - Actual Result: ");
+	printf("Routes %s\n", repaired_network->routes_current ? "up to date" : "out of date");
+
+	// 16.3 - Test removing the link between devices 3 and 2 when incremental routing is on. This splits the network in two,
+	//		  so device 0 can no longer reach device 1, while the routes within each side stay the same
+	delete_network(repaired_network);
+	repaired_network = build_network_from_file(TEST_FILE_PATH);
+	build_routing_tables(repaired_network, ALGORITHM_DIJKSTRA_HEAP);
+	set_incremental_routing(repaired_network, true);
+	remove_link(repaired_network, 3, 2);
+
+	printf("16.3 - Expected Result:\n");
+	printf("From device 0 to device 1 with a cost of -1 and a next hop of -1\n");
+	printf("From device 3 to device 0 with a cost of 1 and a next hop of 0\n");
+	printf("From device 4 to device 1 with a cost of 6 and a next hop of 2\n");
+	printf("16.3 - Actual Result:\n");
+	printf(
+		"From device 0 to device 1 with a cost of %d and a next hop of %d\n",
+		get_route_cost(repaired_network, 0, 1),
+		get_route_next_hop(repaired_network, 0, 1)
+	);
+	printf(
+		"From device 3 to device 0 with a cost of %d and a next hop of %d\n",
+		get_route_cost(repaired_network, 3, 0),
+		get_route_next_hop(repaired_network, 3, 0)
+	);
+	printf(
+		"From device 4 to device 1 with a cost of %d and a next hop of %d\n",
+		get_route_cost(repaired_network, 4, 1),
+		get_route_next_hop(repaired_network, 4, 1)
+	);
+
+	// 16.4 - Test removing a link from each of several devices of a larger network in each route layout. The repaired
+	//		  routing tables should match routing tables built again after the links are removed
+	printf("16.4 - Expected Result: 0, 0 and 0 routes differ\n16.4 - Actual Result: ");
+	for (int layout = ROUTES_PER_DEVICE; layout <= ROUTES_SYMMETRIC; layout++) {
+		delete_network(repaired_network);
+		repaired_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+		set_route_layout(repaired_network, layout);
+		build_routing_tables(repaired_network, ALGORITHM_DIJKSTRA_HEAP);
+		set_incremental_routing(repaired_network, true);
+		remove_test_links(repaired_network, changed_neighbours, 30);
+
+		rebuilt_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+		remove_test_links(rebuilt_network, changed_neighbours, 30);
+		build_routing_tables(rebuilt_network, ALGORITHM_DIJKSTRA_HEAP);
+
+		printf(
+			layout == ROUTES_PER_DEVICE ? "%d" : layout == ROUTES_COMPACT ? ", %d" : " and %d",
+			count_route_differences(repaired_network, rebuilt_network)
+		);
+		delete_network(rebuilt_network);
+	}
+	printf(" routes differ\n");
 
-			start = clock();
-			build_routing_tables(test_network, 1);
-			difference = clock() - start;
-			milliseconds = difference * 1000 / CLOCKS_PER_SEC;
+	// ----------------------------------------------------------------------------------------------------------------
+	// 17 - Test label_components()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n17. label_components() test\n----------------\n");
+
+	// 17.1 - Test a network with three components, one of which is a device with no links. Components are numbered in
+	//		  order of their lowest device
+	island_network = create_network(6);
+	add_link(island_network, 0, 4, 1);
+	add_link(island_network, 1, 3, 2);
+	add_link(island_network, 3, 5, 2);
+	label_components(island_network);
+
+	printf("17.1 - Expected Result: 3 components, labelled 0 1 2 1 0 1, devices 0 4 | 1 3 5 | 2\n17.1 - Actual Result: ");
+	printf("%d components, labelled", island_network->component_count);
+	for (int i = 0; i < island_network->vertices; i++) {
+		printf(" %d", island_network->component_ids[i]);
+	}
+	printf(", devices");
+	for (int i = 0; i < island_network->component_count; i++) {
+		for (int j = island_network->component_offsets[i]; j < island_network->component_offsets[i + 1]; j++) {
+			printf(" %d", island_network->component_devices[j]);
+		}
+		printf(i < island_network->component_count - 1 ? " |" : "\n");
+	}
 
-			printf("Bellman-Ford algorithm - %d devices & %.1f average degrees: %d ms\n", device_counts[device_count], avg_degrees[avg_degree], milliseconds);
+	// 17.2 - Test adding a link between two components. The labels should be dropped and made again when the routing
+	//		  tables are built, and the routes between the joined components found
+	add_link(island_network, 4, 5, 1);
+	printf("17.2 - Expected Result: Labels dropped, then 2 components, from device 0 to device 1 with a cost of 6 and a next hop of 4\n");
+	printf("17.2 - Actual Result: Labels %s, ", island_network->component_ids == NULL ? "dropped" : "kept");
+	build_routing_tables(island_network, ALGORITHM_DIJKSTRA_HEAP);
+	printf(
+		"then %d components, from device 0 to device 1 with a cost of %d and a next hop of %d\n",
+		island_network->component_count,
+		get_route_cost(island_network, 0, 1),
+		get_route_next_hop(island_network, 0, 1)
+	);
 
-			delete_network(test_network);
+	// 17.3 - Test building the routing tables again in each layout after a link that joined two components is removed.
+	//		  Every route between devices in different components should be -1, and every other route should be found
+	printf("17.3 - Expected Result: 0, 0 and 0 routes wrong\n17.3 - Actual Result: ");
+	for (int layout = ROUTES_PER_DEVICE; layout <= ROUTES_SYMMETRIC; layout++) {
+		delete_network(island_network);
+		island_network = build_network_from_file("devices_100_avgdegree_1.0_large_network.txt");
+		set_route_layout(island_network, layout);
+		add_link(island_network, 0, island_network->vertices - 1, 1);
+		build_routing_tables(island_network, layout == ROUTES_COMPACT ? ALGORITHM_SPFA : ALGORITHM_DIJKSTRA_HEAP);
+		remove_link(island_network, 0, island_network->vertices - 1);
+		build_routing_tables(island_network, layout == ROUTES_COMPACT ? ALGORITHM_SPFA : ALGORITHM_DIJKSTRA_HEAP);
+
+		differences = 0;
+		for (int i = 0; i < island_network->vertices; i++) {
+			for (int j = 0; j < island_network->vertices; j++) {
+				if ((get_route_cost(island_network, i, j) == -1) != (i == j || island_network->component_ids[i] != island_network->component_ids[j])) {
+					differences++;
+				}
+			}
 		}
+
+		printf(layout == ROUTES_PER_DEVICE ? "%d" : layout == ROUTES_COMPACT ? ", %d" : " and %d", differences);
+	}
+	printf(" routes wrong\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 18 - Test reorder_devices()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n18. reorder_devices() test\n----------------\n");
+
+	// 18.1 - Test reverse Cuthill-McKee on the test network. Starting from device 0, which has the fewest links and the
+	//		  lowest id, the order is 0 3 2 then 1 and 4, which is reversed. Routes should still use the external ids
+	reordered_network = build_network_from_file(TEST_FILE_PATH);
+	reorder_devices(reordered_network, ORDER_REVERSE_CUTHILL_MCKEE);
+	build_routing_tables(reordered_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("18.1 - Expected Result: External ids 4 1 2 3 0, from device 0 to device 1 with a cost of 6 and a next hop of 3\n");
+	printf("18.1 - Actual Result: External ids");
+	for (int i = 0; i < reordered_network->vertices; i++) {
+		printf(" %d", to_external_id(reordered_network, i));
+	}
+	printf(
+		", from device 0 to device 1 with a cost of %d and a next hop of %d\n",
+		get_route_cost(reordered_network, 0, 1),
+		get_route_next_hop(reordered_network, 0, 1)
+	);
+
+	// 18.2 - Test each order on a larger network, renumbering it twice so that the maps are combined. The routing tables
+	//		  should match those of the network in its loaded order
+	rebuilt_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+	build_routing_tables(rebuilt_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("18.2 - Expected Result: 0, 0 and 0 routes differ\n18.2 - Actual Result: ");
+	for (int order = ORDER_BREADTH_FIRST; order <= ORDER_DEGREE; order++) {
+		delete_network(reordered_network);
+		reordered_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+		reorder_devices(reordered_network, ORDER_DEGREE);
+		reorder_devices(reordered_network, order);
+		build_routing_tables(reordered_network, ALGORITHM_DIJKSTRA_HEAP);
+
+		printf(
+			order == ORDER_BREADTH_FIRST ? "%d" : order == ORDER_REVERSE_CUTHILL_MCKEE ? ", %d" : " and %d",
+			count_route_differences(reordered_network, rebuilt_network)
+		);
+	}
+	printf(" routes differ\n");
+	delete_network(rebuilt_network);
+
+	// 18.3 - Test incremental routing on a renumbered network. The links are changed by their external ids, so the
+	//		  repaired routing tables should match those of a network in its loaded order with the same changes
+	delete_network(reordered_network);
+	reordered_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+	reorder_devices(reordered_network, ORDER_REVERSE_CUTHILL_MCKEE);
+	set_route_layout(reordered_network, ROUTES_SYMMETRIC);
+	build_routing_tables(reordered_network, ALGORITHM_DIJKSTRA_HEAP);
+	set_incremental_routing(reordered_network, true);
+	change_test_links(reordered_network, changed_neighbours, 30);
+	remove_test_links(reordered_network, changed_neighbours, 30);
+
+	rebuilt_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+	change_test_links(rebuilt_network, changed_neighbours, 30);
+	remove_test_links(rebuilt_network, changed_neighbours, 30);
+	build_routing_tables(rebuilt_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("18.3 - Expected Result: 0 routes differ\n18.3 - Actual Result: ");
+	printf("%d routes differ\n", count_route_differences(reordered_network, rebuilt_network));
+	delete_network(rebuilt_network);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 19 - Test build_packed_edges() and delete_packed_edges()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n19. build_packed_edges() and delete_packed_edges() test\n----------------\n");
+
+	// 19.1 - Test packing the test network. Speeds get classes in the order they are first found (1, then 4, then 2), and
+	//		  device 2's links go to 3, 4 and 1
+	packed_edge_network = build_network_from_file(TEST_FILE_PATH);
+	set_edge_packing(packed_edge_network, true);
+	build_routing_tables(packed_edge_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("19.1 - Expected Result: 3 classes, speeds 1 4 2, device 2 links 3(1) 4(2) 1(4)\n19.1 - Actual Result: ");
+	printf("%d classes, speeds", packed_edge_network->packed_edges.class_count);
+	for (int i = 0; i < packed_edge_network->packed_edges.class_count; i++) {
+		printf(" %d", packed_edge_network->packed_edges.speeds[i]);
 	}
+	printf(", device 2 links");
+	for (int i = packed_edge_network->link_offsets[2]; i < packed_edge_network->link_offsets[3]; i++) {
+		printf(
+			" %d(%d)",
+			(int)(packed_edge_network->packed_edges.edges[i] >> SPEED_CLASS_BITS),
+			packed_edge_network->packed_edges.speeds[packed_edge_network->packed_edges.edges[i] & (SPEED_CLASS_COUNT - 1)]
+		);
+	}
+	printf("\n");
+
+	// 19.2 - Test changing a link's speed. The packed edges should be freed, then made again with a new class
+	update_link_speed(packed_edge_network, 0, 3, 7);
+	printf("19.2 - Expected Result: packed edges freed, then 4 classes, from device 0 to device 4 with a cost of 10\n");
+	printf("19.2 - Actual Result: packed edges %s, ", packed_edge_network->packed_edges.edges == NULL ? "freed" : "not freed");
+	build_routing_tables(packed_edge_network, ALGORITHM_SPFA);
+	printf(
+		"then %d classes, from device 0 to device 4 with a cost of %d\n",
+		packed_edge_network->packed_edges.class_count,
+		get_route_cost(packed_edge_network, 0, 4)
+	);
+
+	// 19.3 - Test a network with more speeds than there are classes. It should not be packed, and its routes should still
+	//		  be found from the packed links
+	delete_network(packed_edge_network);
+	packed_edge_network = create_network(SPEED_CLASS_COUNT + 2);
+	for (int i = 0; i <= SPEED_CLASS_COUNT; i++) {
+		add_link(packed_edge_network, i, i + 1, i + 1);
+	}
+	set_edge_packing(packed_edge_network, true);
+	build_routing_tables(packed_edge_network, ALGORITHM_BELLMAN_FORD);
+
+	printf("19.3 - Expected Result: not packed, from device 0 to device %d with a cost of %d\n", SPEED_CLASS_COUNT + 1, (SPEED_CLASS_COUNT + 1) * (SPEED_CLASS_COUNT + 2) / 2);
+	printf(
+		"19.3 - Actual Result: %s, from device 0 to device %d with a cost of %d\n",
+		packed_edge_network->packed_edges.edges == NULL ? "not packed" : "packed",
+		SPEED_CLASS_COUNT + 1,
+		get_route_cost(packed_edge_network, 0, SPEED_CLASS_COUNT + 1)
+	);
+
+	// 19.4 - Test each algorithm that reads the packed edges on a larger network. The routing tables should match those
+	//		  built from the packed links
+	rebuilt_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+	build_routing_tables(rebuilt_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("19.4 - Expected Result: 0, 0, 0 and 0 routes differ\n19.4 - Actual Result: ");
+	for (int algorithm = ALGORITHM_BELLMAN_FORD; algorithm <= ALGORITHM_SPFA; algorithm++) {
+		delete_network(packed_edge_network);
+		packed_edge_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+		set_edge_packing(packed_edge_network, true);
+		build_routing_tables(packed_edge_network, algorithm);
+
+		printf(
+			algorithm == ALGORITHM_BELLMAN_FORD ? "%d" : algorithm < ALGORITHM_SPFA ? ", %d" : " and %d",
+			count_route_differences(packed_edge_network, rebuilt_network)
+		);
+	}
+	printf(" routes differ\n");
+	delete_network(rebuilt_network);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 20 - Test build_routing_tables_floyd_warshall()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n20. build_routing_tables_floyd_warshall() test\n----------------\n");
+
+	// 20.1 - Test Floyd-Warshall on the test network
+	matrix_network = build_network_from_file(TEST_FILE_PATH);
+	build_routing_tables(matrix_network, ALGORITHM_FLOYD_WARSHALL);
+
+	printf("20.1 - Expected Result: From device 0 to device 1 with a cost of 6 and a next hop of 3, 0 to 0 with -1\n");
+	printf(
+		"20.1 - Actual Result: From device 0 to device 1 with a cost of %d and a next hop of %d, 0 to 0 with %d\n",
+		get_route_cost(matrix_network, 0, 1),
+		get_route_next_hop(matrix_network, 0, 1),
+		get_route_cost(matrix_network, 0, 0)
+	);
+
+	// 20.2 - Test Floyd-Warshall with several threads on a network of several tiles, storing the routes in each layout. The
+	//		  routing tables should match those found with Dijkstra's algorithm
+	rebuilt_network = build_network_from_file("devices_500_avgdegree_10.0_large_network.txt");
+	build_routing_tables(rebuilt_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("20.2 - Expected Result: 0, 0 and 0 routes differ\n20.2 - Actual Result: ");
+	for (int layout = ROUTES_PER_DEVICE; layout <= ROUTES_SYMMETRIC; layout++) {
+		delete_network(matrix_network);
+		matrix_network = build_network_from_file("devices_500_avgdegree_10.0_large_network.txt");
+		set_route_layout(matrix_network, layout);
+		build_routing_tables_parallel(matrix_network, ALGORITHM_FLOYD_WARSHALL, 4);
+
+		printf(
+			layout == ROUTES_PER_DEVICE ? "%d" : layout < ROUTES_SYMMETRIC ? ", %d" : " and %d",
+			count_route_differences(matrix_network, rebuilt_network)
+		);
+	}
+	printf(" routes differ\n");
+	delete_network(rebuilt_network);
+
+	// 20.3 - Test Floyd-Warshall on a network split into two components. Devices in different components have no route
+	delete_network(matrix_network);
+	matrix_network = create_network(4);
+	add_link(matrix_network, 0, 1, 3);
+	add_link(matrix_network, 2, 3, 5);
+	build_routing_tables(matrix_network, ALGORITHM_FLOYD_WARSHALL);
+
+	printf("20.3 - Expected Result: 0 to 1 costs 3, 2 to 3 costs 5, 0 to 3 costs -1 with a next hop of -1\n");
+	printf(
+		"20.3 - Actual Result: 0 to 1 costs %d, 2 to 3 costs %d, 0 to 3 costs %d with a next hop of %d\n",
+		get_route_cost(matrix_network, 0, 1),
+		get_route_cost(matrix_network, 2, 3),
+		get_route_cost(matrix_network, 0, 3),
+		get_route_next_hop(matrix_network, 0, 3)
+	);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 21 - Test choose_routing_algorithm() and predict_routing_cost()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n21. choose_routing_algorithm() and predict_routing_cost() test\n----------------\n");
+
+	// 21.1 - Test building the routing tables of the test network automatically. Floyd-Warshall does the least work on so
+	//		  few devices, and its plan should be kept
+	planned_network = build_network_from_file(TEST_FILE_PATH);
+	build_routing_tables(planned_network, ALGORITHM_AUTO);
+
+	printf("21.1 - Expected Result: Floyd-Warshall, From device 0 to device 1 with a cost of 6\n");
+	printf(
+		"21.1 - Actual Result: %s, From device 0 to device 1 with a cost of %d\n",
+		get_algorithm_name(planned_network->routing_plan.algorithm),
+		get_route_cost(planned_network, 0, 1)
+	);
+
+	// 21.2 - Test choosing algorithms for a small dense network, a large dense network and a large sparse network
+	printf("21.2 - Expected Result: Floyd-Warshall, Dijkstra (buckets) and SPFA\n21.2 - Actual Result: ");
+	for (int i = 0; i < 3; i++) {
+		delete_network(planned_network);
+		planned_network = build_network_from_file(PLANNED_FILE_PATHS[i]);
+
+		printf(i == 0 ? "%s" : i == 1 ? ", %s" : " and %s", get_algorithm_name(choose_routing_algorithm(planned_network).algorithm));
+	}
+	printf("\n");
+
+	// 21.3 - Test predicting the cost of each algorithm. Only the algorithms that the bucket queue cannot be used for, and the
+	//		  ones that are never chosen, should have no prediction
+	printf("21.3 - Expected Result: -1 -1 positive positive positive positive, buckets -1 with a speed of 2000\n");
+	printf("21.3 - Actual Result:");
+	for (int algorithm = ALGORITHM_DIJKSTRA; algorithm < ALGORITHM_COUNT; algorithm++) {
+		printf(predict_routing_cost(planned_network, algorithm) > 0 ? " positive" : " %.0f", predict_routing_cost(planned_network, algorithm));
+	}
+	add_link(planned_network, 0, 1, 2000);
+	printf(", buckets %.0f with a speed of 2000\n", predict_routing_cost(planned_network, ALGORITHM_DIJKSTRA_BUCKETS));
+
+	// 21.4 - Test building the routing tables of a larger network automatically. They should match those found with the heap
+	delete_network(planned_network);
+	planned_network = build_network_from_file("devices_500_avgdegree_10.0_large_network.txt");
+	build_routing_tables(planned_network, ALGORITHM_AUTO);
+	rebuilt_network = build_network_from_file("devices_500_avgdegree_10.0_large_network.txt");
+	build_routing_tables(rebuilt_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("21.4 - Expected Result: Dijkstra (buckets), 0 routes differ\n");
+	printf(
+		"21.4 - Actual Result: %s, %d routes differ\n",
+		get_algorithm_name(planned_network->routing_plan.algorithm),
+		count_route_differences(planned_network, rebuilt_network)
+	);
+	delete_network(rebuilt_network);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 22 - Test get_routing_counters() and reset_routing_counters()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n22. get_routing_counters() and reset_routing_counters() test\n----------------\n");
+
+	// 22.1 - Test counting a search from device 0 of the test network. Every device is settled, every link relaxed once and
+	//		  each other device's distance shortened once. Nothing is counted unless the counters are compiled in
+	counted_network = build_network_from_file(TEST_FILE_PATH);
+	find_shortest_paths_dijkstra(counted_network, 0);
+	counters = get_routing_counters(counted_network);
+
+#ifdef ROUTING_COUNTERS
+	printf("22.1 - Expected Result: 1 search, 5 settled, 8 relaxed, 4 shortened, 0 queue operations, 4 routes stored\n");
+#else
+	printf("22.1 - Expected Result: 0 search, 0 settled, 0 relaxed, 0 shortened, 0 queue operations, 0 routes stored\n");
+#endif
+	printf(
+		"22.1 - Actual Result: %lld search, %lld settled, %lld relaxed, %lld shortened, %lld queue operations, %lld routes stored\n",
+		counters.sources,
+		counters.devices_settled,
+		counters.links_relaxed,
+		counters.successful_relaxations,
+		counters.queue_operations,
+		counters.routes_stored
+	);
+
+	// 22.2 - Test counting Bellman-Ford from device 0 of the test network. Its third pass changes nothing, so it stops there
+	reset_routing_counters(counted_network);
+	find_shortest_paths_bellman_ford(counted_network, 0);
+	counters = get_routing_counters(counted_network);
+
+#ifdef ROUTING_COUNTERS
+	printf("22.2 - Expected Result: 3 passes, 24 relaxed\n");
+#else
+	printf("22.2 - Expected Result: 0 passes, 0 relaxed\n");
+#endif
+	printf("22.2 - Actual Result: %lld passes, %lld relaxed\n", counters.bellman_ford_passes, counters.links_relaxed);
+
+	// 22.3 - Test counting SPFA from device 0 of the test network. A device is settled each time it is taken off the queue,
+	//		  and here each device only goes on the queue once, so every link is relaxed once and there are 5 pushes and 5 pops
+	reset_routing_counters(counted_network);
+	find_shortest_paths_spfa(counted_network, 0);
+	counters = get_routing_counters(counted_network);
+
+#ifdef ROUTING_COUNTERS
+	printf("22.3 - Expected Result: 5 settled, 8 relaxed, 4 shortened, 10 queue operations\n");
+#else
+	printf("22.3 - Expected Result: 0 settled, 0 relaxed, 0 shortened, 0 queue operations\n");
+#endif
+	printf(
+		"22.3 - Actual Result: %lld settled, %lld relaxed, %lld shortened, %lld queue operations\n",
+		counters.devices_settled,
+		counters.links_relaxed,
+		counters.successful_relaxations,
+		counters.queue_operations
+	);
+
+	// 22.4 - Test counting every search of a larger network with several threads. Each search with the heap settles every
+	//		  device and relaxes every link once, and each histogram should count every search once
+	delete_network(counted_network);
+	counted_network = build_network_from_file("devices_500_avgdegree_5.0_large_network.txt");
+	build_routing_tables_parallel(counted_network, ALGORITHM_DIJKSTRA_HEAP, 4);
+	counters = get_routing_counters(counted_network);
+
+	histogram_total = 0;
+	for (int i = 0; i < ROUTING_HISTOGRAM_BUCKETS; i++) {
+		histogram_total += counters.time_histogram[i] + counters.links_relaxed_histogram[i];
+	}
+
+#ifdef ROUTING_COUNTERS
+	printf("22.4 - Expected Result: 500 searches, 250000 settled, 1250000 relaxed, 1000 in the histograms\n");
+#else
+	printf("22.4 - Expected Result: 0 searches, 0 settled, 0 relaxed, 0 in the histograms\n");
+#endif
+	printf(
+		"22.4 - Actual Result: %lld searches, %lld settled, %lld relaxed, %lld in the histograms\n",
+		counters.sources,
+		counters.devices_settled,
+		counters.links_relaxed,
+		histogram_total
+	);
+
+	// 22.5 - Test resetting the counters
+	reset_routing_counters(counted_network);
+	printf("22.5 - Expected Result: 0 searches, 0 relaxed\n");
+	printf(
+		"22.5 - Actual Result: %lld searches, %lld relaxed\n",
+		counted_network->routing_counters.sources,
+		counted_network->routing_counters.links_relaxed
+	);
+
+	// Free memory
+	free(known);
+	free(distances);
+	free(previous);
+	free(first_hops);
+	delete_network(empty_network);
+	delete_network(testing_network);
+	delete_network(distance_table_network);
+	delete_network(heap_network);
+	delete_network(slow_network);
+	delete_network(packed_network);
+	delete_network(parallel_network);
+	delete_network(compact_network);
+	delete_network(wide_network);
+	delete_network(symmetric_network);
+	delete_network(repaired_network);
+	delete_network(island_network);
+	delete_network(reordered_network);
+	delete_network(packed_edge_network);
+	delete_network(matrix_network);
+	delete_network(planned_network);
+	delete_network(counted_network);
 }
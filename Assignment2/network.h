@@ -1,9 +1,92 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "priority_queue.h"
+
 // Code is derived from week 9/10 tutorials
 
 typedef char* String;
 
+// The largest link speed that the bucket queue version of Dijkstra's algorithm will use. It needs one bucket per possible
+// speed, so networks with slower links than this fall back to the heap version
+#define BUCKET_QUEUE_MAX_SPEED 1024
+
+// The number of source devices a thread takes at a time when routing tables are built in parallel
+#define ROUTING_CHUNK_SIZE 16
+
+// The number of low bits of a packed edge that hold its speed class. The rest hold the device it goes to, so networks with
+// more than 16 different speeds or 2^28 devices or more are not packed
+#define SPEED_CLASS_BITS 4
+#define SPEED_CLASS_COUNT (1 << SPEED_CLASS_BITS)
+
+// The number of devices along each side of the square tiles that Floyd-Warshall updates the cost matrix in. Three tiles of
+// costs and next hops are used at a time, which fit in the cache together
+#define FLOYD_WARSHALL_TILE_SIZE 64
+
+// The number of buckets in each histogram of the routing counters. Bucket 0 counts searches with a value of 0, and bucket b
+// counts those with a value of at least 2^(b - 1) and less than 2^b, with the last bucket also counting anything larger
+#define ROUTING_HISTOGRAM_BUCKETS 40
+
+typedef enum {
+	ALGORITHM_AUTO = -1,			// Chosen from the size, density and speeds of the network (see choose_routing_algorithm())
+	ALGORITHM_DIJKSTRA = 0,		// Dijkstra's algorithm, finding the closest device with a linear scan
+	ALGORITHM_BELLMAN_FORD = 1,	// The Bellman-Ford algorithm
+	ALGORITHM_DIJKSTRA_HEAP = 2,	// Dijkstra's algorithm, finding the closest device with an indexed binary heap
+	ALGORITHM_DIJKSTRA_BUCKETS = 3,	// Dijkstra's algorithm, finding the closest device with a circular bucket queue (Dial's)
+	ALGORITHM_SPFA = 4,			// Bellman-Ford with a queue of the devices whose distance changed (Shortest Path Faster Algorithm)
+	ALGORITHM_FLOYD_WARSHALL = 5,	// Floyd-Warshall over a matrix of every cost at once, updated a tile at a time
+	ALGORITHM_COUNT				// The number of algorithms. Not an algorithm itself
+} RoutingAlgorithm;
+
+typedef enum {
+	ORDER_BREADTH_FIRST = 0,			// Devices are numbered in the order a breadth first search reaches them
+	ORDER_REVERSE_CUTHILL_MCKEE = 1,	// Breadth first, visiting neighbours with fewer links first, then reversed
+	ORDER_DEGREE = 2					// Devices with more links come first
+} DeviceOrder;
+
+/**
+ * @struct routingPlan
+ * @brief Represents the algorithm chosen to build every routing table of a network
+ *
+ * Contains the chosen algorithm and the predicted cost of building every routing table with it, which is an estimate of the
+ * time taken on one thread in milliseconds. The estimate comes from the number of devices, links and the largest link speed
+ * only, so it is meant for comparing algorithms and for logging rather than as a measurement.
+ */
+typedef struct routingPlan {
+	RoutingAlgorithm algorithm;
+	double predicted_cost;
+} RoutingPlan;
+
+/**
+ * @struct routingCounters
+ * @brief Represents counts of the work done by the routing algorithms, to show why building routing tables is slow
+ *
+ * The counts are only kept when the program is compiled with ROUTING_COUNTERS defined. Otherwise the code that keeps them is
+ * left out entirely, so it costs nothing, and every count stays 0.
+ *
+ * Contains the number of searches from a source device and the time they took in nanoseconds, the number of devices whose
+ * distance became final (settled), the number of links relaxed and how many of those shortened a distance, the number of
+ * pushes, decreases and pops on the heap, bucket queue or SPFA queue, the number of full passes made by Bellman-Ford and the
+ * number of routes stored in the routing tables. time_histogram and links_relaxed_histogram count the searches by their
+ * time and by the links they relaxed (see ROUTING_HISTOGRAM_BUCKETS). Floyd-Warshall does not search from each device, so
+ * it is not counted.
+ */
+typedef struct routingCounters {
+	long long sources;
+	long long nanoseconds;
+	long long devices_settled;
+	long long links_relaxed;
+	long long successful_relaxations;
+	long long queue_operations;
+	long long bellman_ford_passes;
+	long long routes_stored;
+	long long time_histogram[ROUTING_HISTOGRAM_BUCKETS];
+	long long links_relaxed_histogram[ROUTING_HISTOGRAM_BUCKETS];
+} RoutingCounters;
+
 /**
  * @struct link
  * @brief Represents a link that a device has within the adjacency list. 
@@ -47,30 +130,248 @@ typedef struct route {
 	int cost;
 } Route;
 
+/**
+ * @struct routeChange
+ * @brief Represents a route that has been found again after a link was made slower or removed, waiting to be stored
+ *
+ * Contains the device the route starts at, the device it goes to and the new route
+ */
+typedef struct routeChange {
+	int from_device;
+	int to_device;
+	Route route;
+} RouteChange;
+
+typedef enum {
+	ROUTES_PER_DEVICE = 0,	// Each device has its own array of routes
+	ROUTES_COMPACT = 1,		// Every route is in one slab of next hops and one slab of costs, using the narrowest types that fit
+	ROUTES_SYMMETRIC = 2	// As compact, but links cost the same both ways so each cost is stored once in a triangular slab
+} RouteLayout;
+
+/**
+ * @struct routeSlab
+ * @brief Represents the routing tables of every device stored as two contiguous V x V arrays
+ *
+ * Contains the next hops and the costs of every route, with the route from device i to device j at index i * V + j, and
+ * the number of bytes (1, 2 or 4) used by each next hop and each cost. The widths are chosen from the number of devices
+ * and the largest possible route cost. With 1 or 2 bytes, the largest unsigned value stands for -1.
+ *
+ * In the symmetric layout the costs only hold the routes from device i to device j where i < j, in row order, as the route
+ * from j to i costs the same. There are V * (V - 1) / 2 of them, and the cost from device i to itself is always -1.
+ */
+typedef struct routeSlab {
+	void* next_hops;
+	void* costs;
+	int next_hop_bytes;
+	int cost_bytes;
+} RouteSlab;
+
 /**
  * @struct device
  * @brief Represents a device connected to the network
  *
- * Contains lists of a device's links and its routes
+ * Contains lists of a device's links and its routes. The list of links is empty while the network is frozen, as the links
+ * are then stored in the network's packed arrays instead. The routes are NULL until they are first needed, and stay NULL
+ * when the network uses the compact route layout
  */
 typedef struct device {
 	LinkList links;
 	Route* routes;
 } Device;
 
+/**
+ * @struct edgeList
+ * @brief Represents every link in the network as three parallel arrays
+ *
+ * Contains the device each link comes from, the device it goes to and its speed, in the same order as the packed links,
+ * and the number of links. The Bellman-Ford algorithm relaxes every link on each pass, so it reads them in order from
+ * these arrays rather than from the links of each device.
+ */
+typedef struct edgeList {
+	int* from_devices;
+	int* to_devices;
+	int* speeds;
+	int count;
+} EdgeList;
+
+/**
+ * @struct packedEdges
+ * @brief Represents every link in the network as one 32-bit word each
+ *
+ * Contains the packed edges, in the same order as the packed links, and the speed of each speed class. Each edge holds the
+ * device it goes to shifted up by SPEED_CLASS_BITS, with its speed class in the low bits, so its speed is
+ * speeds[edge & (SPEED_CLASS_COUNT - 1)]. This is half the size of a Link, so searches read half as many bytes for the
+ * links they relax. Also contains the number of speed classes used.
+ */
+typedef struct packedEdges {
+	uint32_t* edges;
+	int speeds[SPEED_CLASS_COUNT];
+	int class_count;
+} PackedEdges;
+
+/**
+ * @struct mappedFile
+ * @brief Represents a file that has been mapped into memory
+ *
+ * Contains the start of the file's contents in memory, which is NULL if no file is mapped, and the size of the file
+ */
+typedef struct mappedFile {
+	void* data;
+	size_t size;
+} MappedFile;
+
 /**
  * @struct network
  * @brief Represents a TCP/IP network
  *
- * Contains the number of devices the network has and a list of the links that each device has
+ * Contains the number of devices the network has, a list of the links that each device has and the largest link speed
+ * (weight) in the network.
+ *
+ * A network can also be frozen into compressed sparse row form, where every link is packed into one array ordered by the
+ * device it comes from. The links of device i are packed_links[link_offsets[i]] up to (not including)
+ * packed_links[link_offsets[i + 1]]. Routing algorithms iterate these arrays, so neighbouring links sit next to each
+ * other in memory instead of in separately allocated list nodes. link_offsets is NULL when the network is not frozen.
+ * A frozen network can also have an edge list for the Bellman-Ford algorithm, which is made the first time it is needed
+ * (edges.from_devices is NULL until then) and is freed when the network is thawed. When pack_edges is set, a frozen network
+ * whose speeds fit in the speed classes also has packed edges, which the routing algorithms read instead of the packed
+ * links. They are made when the routing tables are next built (packed_edges.edges is NULL until then) and are freed
+ * whenever the packed links change.
+ *
+ * The routing tables are stored in the given layout, either in each device or in the route slab. They are allocated the
+ * first time they are needed, which routes_allocated records.
+ *
+ * A network loaded from a binary network file keeps the file mapped, and its link offsets and packed links point into the
+ * mapped file (which is read only) rather than into allocated memory.
+ *
+ * The route cache holds the shortest path trees of the devices most recently queried with get_route(). It is NULL until
+ * the first query or until its memory limit is set.
+ *
+ * The devices are also labelled with the connected component (island) they are in, so that routing from a device only has
+ * to look at the devices in its component. The devices of component c are component_devices[component_offsets[c]] up to
+ * (not including) component_devices[component_offsets[c + 1]], in increasing order. component_ids is NULL until the
+ * components are labelled, and the labels are dropped when a link is added between components or a link is removed.
+ *
+ * A network can be renumbered so that linked devices have nearby indexes (see reorder_devices()). Every array is then
+ * indexed by the new (internal) indexes, and external_ids holds the id each device had when it was loaded, with
+ * internal_ids mapping back. Every function that takes or returns a device uses the external ids, apart from the working
+ * memory functions (such as find_shortest_paths() and RoutingScratch), which work on the internal indexes. Both are NULL
+ * if the network has not been renumbered.
+ *
+ * routing_plan is the plan that was chosen the last time the routing tables were built with ALGORITHM_AUTO, and has an
+ * algorithm of ALGORITHM_AUTO if they never have been.
+ *
+ * routing_counters holds the totals of the work done by every search since it was created or reset, which each thread adds to
+ * from the counts in its working memory once it has finished.
+ *
+ * routes_current records whether every routing table has been built and still matches the links. In incremental routing
+ * mode, adding, changing or removing a link repairs the routing tables that it affects instead of leaving them out of
+ * date.
  */
 typedef struct network {
 	int vertices;
 	Device* devices;
+	int max_speed;
+	int* link_offsets;
+	Link* packed_links;
+	int link_count;
+	EdgeList edges;
+	PackedEdges packed_edges;
+	bool pack_edges;
+	RouteLayout route_layout;
+	RouteSlab route_slab;
+	bool routes_allocated;
+	MappedFile mapped_file;
+	struct routeCache* route_cache;
+	bool incremental_routing;
+	bool routes_current;
+	int* component_ids;
+	int* component_offsets;
+	int* component_devices;
+	int component_count;
+	int* external_ids;
+	int* internal_ids;
+	RoutingPlan routing_plan;
+	RoutingCounters routing_counters;
 } Network;
 
 /**
- * @brief Adds a link to the network that goes from a given device to another with a given speed
+ * @struct routingScratch
+ * @brief Represents the working memory used to find the shortest paths from one source device
+ *
+ * Contains arrays of distances, previous hops, first hops and visitations with an entry for each device, the queues used
+ * by the versions of Dijkstra's algorithm and a first-in first-out queue of devices used by SPFA. Building all routing
+ * tables reuses one of these for every source device handled by a thread, rather than allocating the arrays again for
+ * each source.
+ *
+ * When every routing table is being built in the symmetric layout, later_devices_only is set. The search from each device
+ * then only needs to reach the devices after it, as the routes to the devices before it come from their own searches.
+ * When store_routes is not set, the results of a search are left in the arrays rather than copied into the routing tables.
+ *
+ * A search only sets up the devices in its source's component, so searched_component records the component of the last
+ * search (-1 if there has not been one). The devices of that component are reset when a search starts in another one, so
+ * the devices outside of the current component are always unreached.
+ *
+ * counters holds the work done by the searches that used this working memory (see RoutingCounters).
+ */
+typedef struct routingScratch {
+	int* distances;
+	int* previous;
+	int* first_hops;
+	bool* known;
+	IndexedHeap heap;
+	BucketQueue buckets;
+	int* fifo_queue;
+	bool later_devices_only;
+	bool store_routes;
+	int searched_component;
+	RoutingCounters counters;
+} RoutingScratch;
+
+/**
+ * @brief Creates a new network with a given number of devices, no links and empty routing tables
+ *
+ * @param vertices The number of devices in the network
+ *
+ * @return Pointer to the new network
+ */
+Network* create_network(int vertices);
+
+/**
+ * @brief Changes how the network stores its routing tables. Any routes that have already been built are kept
+ *
+ * @param self The network to change
+ * @param layout The new layout. ROUTES_COMPACT stores every route in one slab with narrow types, which takes a quarter
+ *               to a half of the memory on networks with up to 65,535 devices. ROUTES_SYMMETRIC also stores each cost
+ *               once for both directions and fills in the route back to each source from its shortest path tree, so
+ *               building every routing table only searches from each device to the devices after it
+ */
+void set_route_layout(Network* self, RouteLayout layout);
+
+/**
+ * @brief Gets the next hop of the route from one device to another
+ *
+ * @param self The network the devices are in
+ * @param from_device The device the route starts at
+ * @param to_device The device the route goes to
+ *
+ * @return The next hop, or -1 if there is no route
+ */
+int get_route_next_hop(Network* self, int from_device, int to_device);
+
+/**
+ * @brief Gets the cost of the route from one device to another
+ *
+ * @param self The network the devices are in
+ * @param from_device The device the route starts at
+ * @param to_device The device the route goes to
+ *
+ * @return The cost, or -1 if there is no route
+ */
+int get_route_cost(Network* self, int from_device, int to_device);
+
+/**
+ * @brief Adds a link to the network that goes from a given device to another with a given speed. The network is thawed
+ *        first if it is frozen
  *
  * @param self Network to add the device to
  * @param first_device One of the devices (nodes) that the link includes 
@@ -81,7 +382,70 @@ typedef struct network {
 void add_link(Network* self, int first_device, int second_device, int speed);
 
 /**
- * @brief Builds and allocates memory for a network from a file of links. Returns the network.
+ * @brief Changes the speed of the link between two devices, in both directions. If there is more than one link between
+ *        them, the most recently added one is changed. A network loaded from a binary network file is thawed first
+ *
+ * @param self The network the link is in
+ * @param first_device One of the devices that the link includes
+ * @param second_device The other device that the link includes
+ * @param speed The new speed of the link
+ *
+ * @return False if there is no link between the devices, true otherwise
+ */
+bool update_link_speed(Network* self, int first_device, int second_device, int speed);
+
+/**
+ * @brief Removes the link between two devices, in both directions. If there is more than one link between them, the most
+ *        recently added one is removed. A network loaded from a binary network file is thawed first
+ *
+ * @param self The network the link is in
+ * @param first_device One of the devices that the link includes
+ * @param second_device The other device that the link includes
+ *
+ * @return False if there is no link between the devices, true otherwise
+ */
+bool remove_link(Network* self, int first_device, int second_device);
+
+/**
+ * @brief Turns incremental routing on or off. While it is on and every routing table is up to date, add_link() and
+ *        update_link_speed() and remove_link() repair the routing tables they affect. A faster or new link only updates
+ *        the routes between the devices that get closer through it, without searching the network. A slower or removed
+ *        link only finds again the routes that went through it, searching just the devices those routes went to
+ *
+ * @param self The network to change
+ * @param enabled Whether link changes should repair the routing tables
+ */
+void set_incremental_routing(Network* self, bool enabled);
+
+/**
+ * @brief Turns packed edges on or off. While they are on, building routing tables first packs each link into a 32-bit
+ *        word if the network has at most SPEED_CLASS_COUNT different speeds and fewer than 2^28 devices, and the
+ *        routing algorithms then read the packed edges instead of the packed links. Networks that do not fit are routed
+ *        from the packed links as usual
+ *
+ * @param self The network to change
+ * @param enabled Whether the links should be packed
+ */
+void set_edge_packing(Network* self, bool enabled);
+
+/**
+ * @brief Moves every link in the network out of the devices' linked lists and into the packed link arrays. Does nothing
+ *        if the network is already frozen
+ *
+ * @param self The network to freeze
+ */
+void freeze_network(Network* self);
+
+/**
+ * @brief Moves every link in the network out of the packed link arrays and back into the devices' linked lists, keeping
+ *        the order of each device's links. Does nothing if the network is not frozen
+ *
+ * @param self The network to thaw
+ */
+void thaw_network(Network* self);
+
+/**
+ * @brief Builds and allocates memory for a network from a file of links. Returns the network, which is frozen.
  *
  * @param filepath The path of the file to use
  *
@@ -89,20 +453,164 @@ void add_link(Network* self, int first_device, int second_device, int speed);
  */
 Network* build_network_from_file(String filepath);
 
+/**
+ * @brief Builds and allocates memory for a network from a list of links. Returns the network, which is frozen.
+ *
+ * @param vertices The number of devices in the network
+ * @param link_count The number of links, each of which goes both ways
+ * @param first_devices The device at one end of each link
+ * @param second_devices The device at the other end of each link
+ * @param speeds The speed of each link
+ *
+ * @return Pointer to the new network created from the links
+ */
+Network* build_network_from_links(int vertices, int link_count, int* first_devices, int* second_devices, int* speeds);
+
+/**
+ * @brief Renumbers the devices of a network so that devices that are linked to each other are stored close together,
+ *        which keeps the memory that the routing algorithms touch together. The ids used by every function stay the
+ *        same. The network is frozen first, and any routing tables are dropped, as they are stored by internal index
+ *
+ * @param self The network to renumber
+ * @param order How to order the devices (see DeviceOrder)
+ */
+void reorder_devices(Network* self, DeviceOrder order);
+
+/**
+ * @brief Gets the internal index of a device from its external id
+ *
+ * @param self The network the device is in
+ * @param device_id The external id of the device, or -1
+ *
+ * @return The internal index of the device, or -1 if the id was -1
+ */
+int to_internal_id(Network* self, int device_id);
+
+/**
+ * @brief Gets the external id of a device from its internal index
+ *
+ * @param self The network the device is in
+ * @param device_index The internal index of the device, or -1
+ *
+ * @return The external id of the device, or -1 if the index was -1
+ */
+int to_external_id(Network* self, int device_index);
+
+/**
+ * @brief Labels every device with the connected component it is in, with a breadth first search from each device that
+ *        has not been labelled yet. The network is frozen first. Networks built from text files are labelled as they
+ *        are loaded, and other networks are labelled the first time their routing tables are built
+ *
+ * @param self The network to label
+ */
+void label_components(Network* self);
+
 /**
  * @brief Builds a routing table for each device in the network using the specified algorithm
  *
  * @param self The network to build the routing tables of
- * @param algorithm The algorithm to use, 0 for Dijkstra, 1 for Bellman-Ford
+ * @param algorithm The algorithm to use, 0 for Dijkstra, 1 for Bellman-Ford, 2 for Dijkstra with a heap, 3 for Dijkstra
+ *                  with a bucket queue, 4 for SPFA and 5 for Floyd-Warshall (see RoutingAlgorithm). Floyd-Warshall finds
+ *                  every route at once rather than searching from each device, which is faster on small dense networks.
+ *                  ALGORITHM_AUTO (-1) uses the algorithm chosen by choose_routing_algorithm(), and keeps its plan in
+ *                  routing_plan
  */
 void build_routing_tables(Network* self, int algorithm);
 
 /**
- * @brief Compares two algorithms for time taken to build a full routing table for each device in the network
+ * @brief Predicts the cost of building every routing table of a network with an algorithm, from the number of devices,
+ *        the number of links and the largest link speed. The network is frozen first
+ *
+ * @param self The network to predict the cost for
+ * @param algorithm The algorithm to predict the cost of (see RoutingAlgorithm)
+ *
+ * @return The estimated time taken on one thread in milliseconds, or -1 if the algorithm cannot be used on the network
+ */
+double predict_routing_cost(Network* self, int algorithm);
+
+/**
+ * @brief Chooses the algorithm predicted to build every routing table of a network the fastest. Dijkstra's algorithm with
+ *        a linear scan and Bellman-Ford are never chosen, as another algorithm is always faster
+ *
+ * @param self The network to choose an algorithm for
+ *
+ * @return The chosen algorithm and its predicted cost
+ */
+RoutingPlan choose_routing_algorithm(Network* self);
+
+/**
+ * @brief Gets the name of an algorithm, for logging
+ *
+ * @param algorithm The algorithm (see RoutingAlgorithm)
+ *
+ * @return The name of the algorithm, or "unknown" if it is not one
+ */
+String get_algorithm_name(int algorithm);
+
+/**
+ * @brief Gets the totals of the work done by the routing algorithms on a network since it was created or its counters were
+ *        last reset. Every count is 0 unless the program is compiled with ROUTING_COUNTERS defined
+ *
+ * @param self The network to get the counters of
+ *
+ * @return A copy of the counters
+ */
+RoutingCounters get_routing_counters(Network* self);
+
+/**
+ * @brief Sets every routing counter of a network back to 0
+ *
+ * @param self The network to reset the counters of
+ */
+void reset_routing_counters(Network* self);
+
+/**
+ * @brief Builds a routing table for each device in the network using the specified algorithm, sharing the source devices
+ *        between threads. Threads are only used when the program is compiled with OpenMP
+ *
+ * @param self The network to build the routing tables of
+ * @param algorithm The algorithm to use (see RoutingAlgorithm)
+ * @param thread_count The number of threads to use, or 0 to use one for each processor
+ */
+void build_routing_tables_parallel(Network* self, int algorithm, int thread_count);
+
+/**
+ * @brief Creates the working memory needed to find the shortest paths from one device in a network
+ *
+ * @param self The network the working memory is for
+ *
+ * @return The new working memory
+ */
+RoutingScratch create_routing_scratch(Network* self);
+
+/**
+ * @brief Frees the working memory used to find shortest paths
+ *
+ * @param self Pointer to the working memory to delete
+ */
+void delete_routing_scratch(RoutingScratch* self);
+
+/**
+ * @brief Finds the shortest paths from one device with the given algorithm, and builds its routing table unless the
+ *        working memory's store_routes is not set. Only the devices in the device's component are searched, and its
+ *        routes to every other device are set to -1. The network must be frozen, and have an edge list for Bellman-Ford.
+ *        Floyd-Warshall cannot find the routes from only one device, so Dijkstra's algorithm with a heap is used for it
+ *
+ * @param self The network to search
+ * @param device_index The device to find the shortest paths from
+ * @param algorithm The algorithm to use (see RoutingAlgorithm)
+ * @param scratch Pointer to the working memory to use, which holds the distances and first hops afterwards
+ *
+ * @return False if the algorithm is not supported, true otherwise
+ */
+bool find_shortest_paths(Network* self, int device_index, int algorithm, RoutingScratch* scratch);
+
+/**
+ * @brief Frees the memory used by a network, including its links and routing tables
  *
- * @param The filename of the file storing information about the network to base the comparison on
+ * @param self The network to delete
  */
-void compare_algorithms(String file_name);
+void delete_network(Network* self);
 
 /**
  * @brief Tests all of the functions within this file
@@ -0,0 +1,303 @@
+// network_file.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "network.h"
+#include "network_file.h"
+
+
+// Writes a network to a binary network file, freezing it first so that its links are already in the order they are written.
+// A renumbered network is written in the order of its external ids, so the file holds the ids it was loaded with
+bool save_network_binary(Network* self, String filepath) {
+	FILE* file; // The file to write to
+	NetworkFileHeader header; // The header of the file
+	bool written; // Whether every part of the file was written
+	int* link_offsets; // The link offsets to write
+	Link* packed_links; // The packed links to write
+	int link_index = 0; // The index in the packed links to write that the next link goes into
+	int device_index; // The internal index of the current device
+
+	freeze_network(self);
+
+	file = fopen(filepath, "wb");
+	if (file == NULL) {
+		printf("Error opening file!\n");
+		return false;
+	}
+
+	memcpy(header.magic, NETWORK_FILE_MAGIC, sizeof header.magic);
+	header.version = NETWORK_FILE_VERSION;
+	header.vertices = self->vertices;
+	header.link_count = self->link_count;
+	header.max_speed = self->max_speed;
+	header.reserved = 0;
+
+	link_offsets = self->link_offsets;
+	packed_links = self->packed_links;
+	if (self->external_ids != NULL) {
+		link_offsets = malloc((sizeof(int)) * (self->vertices + 1));
+		packed_links = malloc((sizeof(Link)) * (self->link_count > 0 ? self->link_count : 1));
+
+		for (int i = 0; i < self->vertices; i++) {
+			link_offsets[i] = link_index;
+			device_index = to_internal_id(self, i);
+
+			for (int j = self->link_offsets[device_index]; j < self->link_offsets[device_index + 1]; j++) {
+				packed_links[link_index].to_device = to_external_id(self, self->packed_links[j].to_device);
+				packed_links[link_index].speed = self->packed_links[j].speed;
+				link_index++;
+			}
+		}
+		link_offsets[self->vertices] = link_index;
+	}
+
+	written =
+		fwrite(&header, sizeof header, 1, file) == 1 &&
+		fwrite(link_offsets, sizeof * link_offsets, self->vertices + 1, file) == (size_t)self->vertices + 1 &&
+		fwrite(packed_links, sizeof * packed_links, self->link_count, file) == (size_t)self->link_count;
+
+	if (fclose(file) != 0) {
+		written = false;
+	}
+
+	if (link_offsets != self->link_offsets) {
+		free(link_offsets);
+		free(packed_links);
+	}
+
+	return written;
+}
+
+// Converts a text network file to a binary network file
+bool convert_network_file(String text_filepath, String binary_filepath) {
+	Network* text_network = build_network_from_file(text_filepath); // The network read from the text file
+	bool converted; // Whether the binary file was written
+
+	if (text_network == NULL) {
+		return false;
+	}
+
+	converted = save_network_binary(text_network, binary_filepath);
+	delete_network(text_network);
+
+	return converted;
+}
+
+// Maps a whole file into memory as read only. Returns false if the file cannot be opened or mapped, or is empty
+bool map_file(String filepath, MappedFile* mapped_file) {
+#ifdef _WIN32
+	HANDLE file; // The opened file
+	HANDLE mapping; // The mapping of the file
+	LARGE_INTEGER file_size; // The size of the file in bytes
+
+	file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		CloseHandle(file);
+		return false;
+	}
+
+	// The view keeps the file mapped after both handles are closed
+	mapped_file->data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	mapped_file->size = (size_t)file_size.QuadPart;
+	CloseHandle(mapping);
+	CloseHandle(file);
+
+	return mapped_file->data != NULL;
+#else
+	int file; // The opened file
+	struct stat file_status; // The status of the file, which holds its size
+	void* data; // The start of the mapped file
+
+	file = open(filepath, O_RDONLY);
+	if (file == -1) {
+		return false;
+	}
+
+	if (fstat(file, &file_status) != 0 || file_status.st_size == 0) {
+		close(file);
+		return false;
+	}
+
+	// The mapping keeps the file mapped after it is closed
+	data = mmap(NULL, (size_t)file_status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (data == MAP_FAILED) {
+		mapped_file->data = NULL;
+		return false;
+	}
+
+	mapped_file->data = data;
+	mapped_file->size = (size_t)file_status.st_size;
+
+	return true;
+#endif
+}
+
+// Unmaps a file that was mapped by map_file()
+void unmap_network_file(MappedFile* self) {
+	if (self->data == NULL) {
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(self->data);
+#else
+	munmap(self->data, self->size);
+#endif
+
+	self->data = NULL;
+	self->size = 0;
+}
+
+// Checks whether a mapped file holds a complete network in the binary network format. Only the header and the first and
+// last offsets are read, so that loading does not touch the rest of the file
+bool is_valid_network_file(MappedFile* mapped_file) {
+	NetworkFileHeader* header = mapped_file->data; // The header at the start of the file
+	int* link_offsets; // The link offsets that follow the header
+
+	if (
+		mapped_file->size < sizeof * header || memcmp(header->magic, NETWORK_FILE_MAGIC, sizeof header->magic) != 0 ||
+		header->version != NETWORK_FILE_VERSION || header->vertices < 0 || header->link_count < 0
+	) {
+		return false;
+	}
+
+	if (
+		mapped_file->size != sizeof * header + sizeof(int) * ((size_t)header->vertices + 1) +
+		sizeof(Link) * (size_t)header->link_count
+	) {
+		return false;
+	}
+
+	link_offsets = (int*)(header + 1);
+
+	return link_offsets[0] == 0 && link_offsets[header->vertices] == header->link_count;
+}
+
+// Loads a network from a binary network file. The network's link offsets and packed links point straight into the mapped
+// file, so nothing is parsed or copied and only the pages that are used are read from disk
+Network* map_network_from_file(String filepath) {
+	MappedFile mapped_file; // The mapped binary file
+	NetworkFileHeader* header; // The header at the start of the file
+	Network* new_network; // The new network
+
+	if (!map_file(filepath, &mapped_file)) {
+		printf("Error opening file!\n");
+		return NULL;
+	}
+
+	if (!is_valid_network_file(&mapped_file)) {
+		printf("Error: Not a network file!\n");
+		unmap_network_file(&mapped_file);
+		return NULL;
+	}
+
+	header = mapped_file.data;
+	new_network = create_network(header->vertices);
+	new_network->max_speed = header->max_speed;
+	new_network->link_count = header->link_count;
+	new_network->link_offsets = (int*)(header + 1);
+	new_network->packed_links = (Link*)(new_network->link_offsets + header->vertices + 1);
+	new_network->mapped_file = mapped_file;
+
+	return new_network;
+}
+
+void test_network_file() {
+	const String TEST_FILE_PATH = "test_graph.txt"; // The path of the file containing the test network
+	const String BINARY_FILE_PATH = "test_graph.bin"; // The path of the binary file made from the test network
+	Network* text_network = build_network_from_file(TEST_FILE_PATH); // The test network read from the text file
+	Network* mapped_network; // The test network loaded from the binary file
+	int differences; // The number of links or offsets that differ between the two networks
+
+	printf("\n------------------------------------------------------\n                *network_file.c tests*\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 1 - Test convert_network_file(), save_network_binary() and map_network_from_file()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n1. convert_network_file() and map_network_from_file() test\n----------------\n");
+
+	// 1.1 - Test converting the test network and loading it back. The mapped network should have the same offsets and
+	//		 links as the network read from the text file
+	printf("1.1 - Expected Result: converted, 5 devices, 8 links, max speed 4, 0 differences\n1.1 - Actual Result: ");
+	printf("%s, ", convert_network_file(TEST_FILE_PATH, BINARY_FILE_PATH) ? "converted" : "not converted");
+
+	mapped_network = map_network_from_file(BINARY_FILE_PATH);
+
+	differences = 0;
+	for (int i = 0; i <= text_network->vertices; i++) {
+		if (mapped_network->link_offsets[i] != text_network->link_offsets[i]) {
+			differences++;
+		}
+	}
+	for (int i = 0; i < text_network->link_count; i++) {
+		if (
+			mapped_network->packed_links[i].to_device != text_network->packed_links[i].to_device ||
+			mapped_network->packed_links[i].speed != text_network->packed_links[i].speed
+		) {
+			differences++;
+		}
+	}
+	printf(
+		"%d devices, %d links, max speed %d, %d differences\n",
+		mapped_network->vertices,
+		mapped_network->link_count,
+		mapped_network->max_speed,
+		differences
+	);
+
+	// 1.2 - Test building routing tables on the mapped network. The links are read straight from the mapped file
+	build_routing_tables(mapped_network, ALGORITHM_DIJKSTRA_HEAP);
+
+	printf("1.2 - Expected Result: From device 0 to device 1 with a cost of 6 and a next hop of 3\n");
+	printf(
+		"1.2 - Actual Result: From device 0 to device 1 with a cost of %d and a next hop of %d\n",
+		get_route_cost(mapped_network, 0, 1),
+		get_route_next_hop(mapped_network, 0, 1)
+	);
+
+	// 1.3 - Test adding a link to the mapped network. The links should be copied into the lists and the file unmapped
+	add_link(mapped_network, 0, 4, 1);
+
+	printf("1.3 - Expected Result: file unmapped, device 0 links 4(1) 3(1)\n1.3 - Actual Result: ");
+	printf("file %s, device 0 links", mapped_network->mapped_file.data == NULL ? "unmapped" : "not unmapped");
+	for (LinkNodePtr current = mapped_network->devices[0].links.head; current != NULL; current = current->next) {
+		printf(" %d(%d)", current->link.to_device, current->link.speed);
+	}
+	printf("\n");
+
+	// 1.4 - Test loading a file that does not exist
+	printf("1.4 - Expected Result: Error opening file!\n1.4 - Actual Result: ");
+	map_network_from_file("missing_network.bin");
+
+	// 1.5 - Test loading a file that is not a binary network file
+	printf("1.5 - Expected Result: Error: Not a network file!\n1.5 - Actual Result: ");
+	map_network_from_file(TEST_FILE_PATH);
+
+	// Free memory
+	delete_network(text_network);
+	delete_network(mapped_network);
+	remove(BINARY_FILE_PATH);
+}
@@ -0,0 +1,73 @@
+// network_file.h
+#pragma once
+
+#include <stdbool.h>
+
+#include "network.h"
+
+// The first four bytes of every binary network file
+#define NETWORK_FILE_MAGIC "RNET"
+
+// The version of the binary network file format written by this program
+#define NETWORK_FILE_VERSION 1
+
+/**
+ * @struct networkFileHeader
+ * @brief Represents the start of a binary network file
+ *
+ * Contains the magic bytes, the version of the format, the number of devices, the number of packed links and the largest
+ * link speed. The header is followed by the link offsets (vertices + 1 ints) and then the packed links (link_count Links),
+ * exactly as they are laid out in a frozen network, so a mapped file can be used as the network's links without being
+ * parsed or copied. Every value is in the byte order of the machine that wrote the file, which the version also checks.
+ */
+typedef struct networkFileHeader {
+	char magic[4];
+	int version;
+	int vertices;
+	int link_count;
+	int max_speed;
+	int reserved;
+} NetworkFileHeader;
+
+/**
+ * @brief Writes a network to a binary network file. The network is frozen first
+ *
+ * @param self The network to write
+ * @param filepath The path of the file to write to
+ *
+ * @return True if the file was written, false otherwise
+ */
+bool save_network_binary(Network* self, String filepath);
+
+/**
+ * @brief Converts a text network file (the number of devices, then one "device,device,speed" line per link) to a binary
+ *        network file
+ *
+ * @param text_filepath The path of the text file to read
+ * @param binary_filepath The path of the binary file to write
+ *
+ * @return True if the file was converted, false otherwise
+ */
+bool convert_network_file(String text_filepath, String binary_filepath);
+
+/**
+ * @brief Loads a network from a binary network file by mapping the file into memory. The network is frozen, and its link
+ *        offsets and packed links point into the mapped file until it is thawed or deleted
+ *
+ * @param filepath The path of the binary file to load
+ *
+ * @return Pointer to the new network, or NULL if the file cannot be opened or is not a valid network file
+ */
+Network* map_network_from_file(String filepath);
+
+/**
+ * @brief Unmaps a file that was mapped by map_network_from_file()
+ *
+ * @param self Pointer to the mapped file to unmap
+ */
+void unmap_network_file(MappedFile* self);
+
+/**
+ * @brief Tests all of the functions within this file
+ */
+void test_network_file();
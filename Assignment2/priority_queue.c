@@ -0,0 +1,358 @@
+// priority_queue.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "priority_queue.h"
+
+
+// Creates and returns a new, empty heap that can hold devices 0 to capacity - 1
+IndexedHeap create_indexed_heap(int capacity) {
+	IndexedHeap new_heap; // The newly created heap
+
+	new_heap.entries = malloc((sizeof * new_heap.entries) * capacity);
+	new_heap.positions = malloc((sizeof * new_heap.positions) * capacity);
+	new_heap.size = 0;
+	new_heap.capacity = capacity;
+
+	for (int i = 0; i < capacity; i++)
+	{
+		new_heap.positions[i] = -1;
+	}
+
+	return new_heap;
+}
+
+// Checks whether the first entry should be closer to the top of the heap than the second. Devices with the same priority
+// are ordered by index so that ties are resolved the same way as the linear scan in find_shortest_paths_dijkstra
+bool heap_entry_before(HeapEntry first, HeapEntry second) {
+	return first.priority < second.priority || (first.priority == second.priority && first.device < second.device);
+}
+
+// Places an entry at a position in the heap array and records the position against the entry's device
+void heap_place(IndexedHeap* self, HeapEntry entry, int position) {
+	self->entries[position] = entry;
+	self->positions[entry.device] = position;
+}
+
+// Moves the entry at the given position up the heap until its parent comes before it
+void heap_sift_up(IndexedHeap* self, int position) {
+	HeapEntry entry = self->entries[position]; // The entry being moved up
+	int parent; // The position of the entry's current parent
+
+	while (position > 0) {
+		parent = (position - 1) / 2;
+
+		if (!heap_entry_before(entry, self->entries[parent])) {
+			break;
+		}
+
+		heap_place(self, self->entries[parent], position);
+		position = parent;
+	}
+
+	heap_place(self, entry, position);
+}
+
+// Moves the entry at the given position down the heap until it comes before both of its children
+void heap_sift_down(IndexedHeap* self, int position) {
+	HeapEntry entry = self->entries[position]; // The entry being moved down
+	int child; // The position of the child that comes first
+
+	while (2 * position + 1 < self->size) {
+		child = 2 * position + 1;
+
+		// Use the right child if it comes before the left child
+		if (child + 1 < self->size && heap_entry_before(self->entries[child + 1], self->entries[child])) {
+			child++;
+		}
+
+		if (!heap_entry_before(self->entries[child], entry)) {
+			break;
+		}
+
+		heap_place(self, self->entries[child], position);
+		position = child;
+	}
+
+	heap_place(self, entry, position);
+}
+
+// Inserts a device into the heap, or lowers its priority if it is already in the heap
+void heap_push_or_decrease(IndexedHeap* self, int device, int priority) {
+	int position = self->positions[device]; // The current position of the device in the heap
+
+	// If the device is not in the heap, add it to the end of the heap
+	if (position == -1) {
+		position = self->size;
+		self->size++;
+	}
+
+	self->entries[position].device = device;
+	self->entries[position].priority = priority;
+	heap_sift_up(self, position);
+}
+
+// Removes and returns the entry with the lowest priority
+HeapEntry heap_pop_min(IndexedHeap* self) {
+	HeapEntry min_entry = self->entries[0]; // The entry at the top of the heap
+
+	self->positions[min_entry.device] = -1;
+	self->size--;
+
+	// Move the last entry to the top and restore the heap order
+	if (self->size > 0) {
+		self->entries[0] = self->entries[self->size];
+		heap_sift_down(self, 0);
+	}
+
+	return min_entry;
+}
+
+// Checks whether the heap has no entries in it
+bool heap_is_empty(IndexedHeap* self) {
+	return self->size == 0;
+}
+
+// Removes every entry from the heap
+void heap_clear(IndexedHeap* self) {
+	for (int i = 0; i < self->size; i++) {
+		self->positions[self->entries[i].device] = -1;
+	}
+
+	self->size = 0;
+}
+
+// Frees the memory used by a heap
+void delete_indexed_heap(IndexedHeap* self) {
+	free(self->entries);
+	free(self->positions);
+	self->entries = NULL;
+	self->positions = NULL;
+	self->size = 0;
+	self->capacity = 0;
+}
+
+// Creates and returns a new, empty bucket queue that can hold devices 0 to capacity - 1
+BucketQueue create_bucket_queue(int capacity, int max_step) {
+	BucketQueue new_queue; // The newly created queue
+
+	// One more bucket than the largest step so that the newest priority never wraps onto the lowest one
+	new_queue.bucket_count = max_step + 1;
+	new_queue.bucket_heads = malloc((sizeof * new_queue.bucket_heads) * new_queue.bucket_count);
+	new_queue.next_in_bucket = malloc((sizeof * new_queue.next_in_bucket) * capacity);
+	new_queue.previous_in_bucket = malloc((sizeof * new_queue.previous_in_bucket) * capacity);
+	new_queue.priorities = malloc((sizeof * new_queue.priorities) * capacity);
+	new_queue.queued = malloc((sizeof * new_queue.queued) * capacity);
+	new_queue.current_bucket = 0;
+	new_queue.size = 0;
+
+	for (int i = 0; i < new_queue.bucket_count; i++)
+	{
+		new_queue.bucket_heads[i] = -1;
+	}
+
+	for (int i = 0; i < capacity; i++)
+	{
+		new_queue.queued[i] = false;
+	}
+
+	return new_queue;
+}
+
+// Unlinks a queued device from the bucket it is in
+void bucket_unlink(BucketQueue* self, int device) {
+	int bucket = self->priorities[device] % self->bucket_count; // The bucket the device is in
+
+	if (self->previous_in_bucket[device] != -1) {
+		self->next_in_bucket[self->previous_in_bucket[device]] = self->next_in_bucket[device];
+	}
+	else {
+		self->bucket_heads[bucket] = self->next_in_bucket[device];
+	}
+
+	if (self->next_in_bucket[device] != -1) {
+		self->previous_in_bucket[self->next_in_bucket[device]] = self->previous_in_bucket[device];
+	}
+
+	self->queued[device] = false;
+	self->size--;
+}
+
+// Inserts a device into the queue, or moves it to a lower priority if it is already in the queue
+void bucket_push_or_decrease(BucketQueue* self, int device, int priority) {
+	int bucket = priority % self->bucket_count; // The bucket the device belongs in
+
+	if (self->queued[device]) {
+		bucket_unlink(self, device);
+	}
+
+	// Add the device to the front of its bucket
+	self->priorities[device] = priority;
+	self->previous_in_bucket[device] = -1;
+	self->next_in_bucket[device] = self->bucket_heads[bucket];
+	if (self->bucket_heads[bucket] != -1) {
+		self->previous_in_bucket[self->bucket_heads[bucket]] = device;
+	}
+	self->bucket_heads[bucket] = device;
+
+	self->queued[device] = true;
+	self->size++;
+}
+
+// Removes and returns a device with the lowest priority
+HeapEntry bucket_pop_min(BucketQueue* self) {
+	HeapEntry min_entry; // The entry with the lowest priority
+
+	// Move around the circle of buckets until one has a device in it
+	while (self->bucket_heads[self->current_bucket] == -1) {
+		self->current_bucket = (self->current_bucket + 1) % self->bucket_count;
+	}
+
+	min_entry.device = self->bucket_heads[self->current_bucket];
+	min_entry.priority = self->priorities[min_entry.device];
+	bucket_unlink(self, min_entry.device);
+
+	return min_entry;
+}
+
+// Removes every device from the queue
+void bucket_clear(BucketQueue* self) {
+	while (self->size > 0) {
+		bucket_pop_min(self);
+	}
+}
+
+// Frees the memory used by a bucket queue
+void delete_bucket_queue(BucketQueue* self) {
+	free(self->bucket_heads);
+	free(self->next_in_bucket);
+	free(self->previous_in_bucket);
+	free(self->priorities);
+	free(self->queued);
+	self->bucket_heads = NULL;
+	self->next_in_bucket = NULL;
+	self->previous_in_bucket = NULL;
+	self->priorities = NULL;
+	self->queued = NULL;
+	self->size = 0;
+}
+
+// Tests all functions in this file
+void test_priority_queue() {
+	// Note about testing heap_place, heap_sift_up, heap_sift_down and heap_entry_before: These are helper functions that are
+	// called by every push and pop. Each of the tests below relies on them ordering the heap correctly, so they do not
+	// need to be tested separately. The same is true for bucket_unlink.
+
+	IndexedHeap testing_heap = create_indexed_heap(6); // The heap used for testing this file
+	BucketQueue testing_queue = create_bucket_queue(6, 8); // The bucket queue used for testing this file
+	HeapEntry popped_entry; // The most recently popped entry
+
+	printf("\n------------------------------------------------------\n               *priority_queue.c tests*\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 1 - Test create_indexed_heap() and heap_is_empty()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n1. create_indexed_heap() and heap_is_empty() test\n----------------\n");
+
+	// 1.1 - A newly created heap should be empty
+	printf("1.1 - Expected Result: true\n1.1 - Actual Result: ");
+	printf("%s\n", heap_is_empty(&testing_heap) ? "true" : "false");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 2 - Test heap_push_or_decrease() and heap_pop_min()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n2. heap_push_or_decrease() and heap_pop_min() test\n----------------\n");
+
+	// 2.1 - Test that devices pushed out of order are popped in order of priority. This tests sifting up and down.
+	heap_push_or_decrease(&testing_heap, 0, 8);
+	heap_push_or_decrease(&testing_heap, 1, 3);
+	heap_push_or_decrease(&testing_heap, 2, 5);
+	heap_push_or_decrease(&testing_heap, 3, 1);
+
+	printf("2.1 - Expected Result: device 3 (1), device 1 (3), device 2 (5), device 0 (8)\n2.1 - Actual Result: ");
+	while (!heap_is_empty(&testing_heap)) {
+		popped_entry = heap_pop_min(&testing_heap);
+		printf("device %d (%d)", popped_entry.device, popped_entry.priority);
+		printf("%s", heap_is_empty(&testing_heap) ? "\n" : ", ");
+	}
+
+	// 2.2 - Test decreasing the priority of a device that is already in the heap. The device should move to the top
+	//       and should not be added twice
+	heap_push_or_decrease(&testing_heap, 4, 6);
+	heap_push_or_decrease(&testing_heap, 5, 7);
+	heap_push_or_decrease(&testing_heap, 5, 2);
+
+	printf("2.2 - Expected Result: device 5 (2), size 2\n2.2 - Actual Result: ");
+	printf("device %d (%d), size %d\n", testing_heap.entries[0].device, testing_heap.entries[0].priority, testing_heap.size);
+
+	// 2.3 - Test that devices with the same priority are popped in order of index
+	heap_push_or_decrease(&testing_heap, 0, 2);
+
+	printf("2.3 - Expected Result: device 0 (2), device 5 (2), device 4 (6)\n2.3 - Actual Result: ");
+	while (!heap_is_empty(&testing_heap)) {
+		popped_entry = heap_pop_min(&testing_heap);
+		printf("device %d (%d)", popped_entry.device, popped_entry.priority);
+		printf("%s", heap_is_empty(&testing_heap) ? "\n" : ", ");
+	}
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 3 - Test bucket_push_or_decrease() and bucket_pop_min()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n3. bucket_push_or_decrease() and bucket_pop_min() test\n----------------\n");
+
+	// 3.1 - Test that devices are popped in order of priority. Priority 9 falls in the first of the 9 buckets, so it must
+	//       only be popped once the queue has wrapped around. Devices in the same bucket are popped newest first
+	bucket_push_or_decrease(&testing_queue, 0, 4);
+	bucket_push_or_decrease(&testing_queue, 1, 1);
+	bucket_push_or_decrease(&testing_queue, 2, 8);
+
+	printf("3.1 - Expected Result: device 1 (1), device 0 (4), device 2 (9), device 3 (9)\n3.1 - Actual Result: ");
+	popped_entry = bucket_pop_min(&testing_queue);
+	printf("device %d (%d), ", popped_entry.device, popped_entry.priority);
+
+	// Now that priority 1 has been popped, priority 9 is within 8 of the lowest priority. Device 2 is moved down to 9
+	bucket_push_or_decrease(&testing_queue, 3, 9);
+	bucket_push_or_decrease(&testing_queue, 2, 9);
+	while (testing_queue.size > 0) {
+		popped_entry = bucket_pop_min(&testing_queue);
+		printf("device %d (%d)", popped_entry.device, popped_entry.priority);
+		printf("%s", testing_queue.size == 0 ? "\n" : ", ");
+	}
+
+	// 3.2 - Test moving a device to a lower priority when it is in the middle of a bucket. This unlinks it from both
+	//       neighbours in its old bucket
+	bucket_push_or_decrease(&testing_queue, 0, 12);
+	bucket_push_or_decrease(&testing_queue, 1, 12);
+	bucket_push_or_decrease(&testing_queue, 2, 12);
+	bucket_push_or_decrease(&testing_queue, 1, 10);
+
+	printf("3.2 - Expected Result: device 1 (10), 2 devices left\n3.2 - Actual Result: ");
+	popped_entry = bucket_pop_min(&testing_queue);
+	printf("device %d (%d), %d devices left\n", popped_entry.device, popped_entry.priority, testing_queue.size);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 4 - Test heap_clear() and bucket_clear()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n4. heap_clear() and bucket_clear() test\n----------------\n");
+
+	// 4.1 - Test clearing a heap that has devices in it. Each device should no longer have a position, so pushing one again
+	//       adds a new entry rather than decreasing an old one
+	heap_push_or_decrease(&testing_heap, 1, 7);
+	heap_push_or_decrease(&testing_heap, 2, 3);
+	heap_clear(&testing_heap);
+	heap_push_or_decrease(&testing_heap, 1, 9);
+
+	printf("4.1 - Expected Result: device 1 (9), heap empty\n4.1 - Actual Result: ");
+	popped_entry = heap_pop_min(&testing_heap);
+	printf("device %d (%d), heap %s\n", popped_entry.device, popped_entry.priority, heap_is_empty(&testing_heap) ? "empty" : "not empty");
+
+	// 4.2 - Test clearing a bucket queue that has devices in it. Both devices left from 3.2 should be removed
+	bucket_clear(&testing_queue);
+
+	printf("4.2 - Expected Result: 0 devices left, device 0 not queued\n4.2 - Actual Result: ");
+	printf("%d devices left, device 0 %s\n", testing_queue.size, testing_queue.queued[0] ? "queued" : "not queued");
+
+	delete_indexed_heap(&testing_heap);
+	delete_bucket_queue(&testing_queue);
+}
@@ -0,0 +1,148 @@
+// priority_queue.h
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @struct heapEntry
+ * @brief Represents a device waiting in the priority queue
+ *
+ * Contains the index of the device and its priority (the distance found to it so far)
+ */
+typedef struct heapEntry {
+	int device;
+	int priority;
+} HeapEntry;
+
+/**
+ * @struct indexedHeap
+ * @brief Represents an indexed binary min-heap of devices
+ *
+ * Contains the heap array, the position of each device within the heap array (-1 if the device is not in the heap),
+ * the number of entries in the heap and the number of devices the heap can hold. Keeping the position of each device
+ * allows a device's priority to be decreased without searching the heap for it.
+ */
+typedef struct indexedHeap {
+	HeapEntry* entries;
+	int* positions;
+	int size;
+	int capacity;
+} IndexedHeap;
+
+/**
+ * @brief Creates a new, empty indexed heap that can hold devices 0 to capacity - 1
+ *
+ * @param capacity The number of devices the heap can hold
+ *
+ * @return The new heap
+ */
+IndexedHeap create_indexed_heap(int capacity);
+
+/**
+ * @brief Inserts a device into the heap, or lowers its priority if it is already in the heap
+ *
+ * @param self Pointer to the heap to insert into
+ * @param device The device to insert
+ * @param priority The new priority of the device. Must not be larger than its current priority if it is in the heap
+ */
+void heap_push_or_decrease(IndexedHeap* self, int device, int priority);
+
+/**
+ * @brief Removes and returns the entry with the lowest priority. Ties are broken by the lowest device index
+ *
+ * @param self Pointer to the heap to remove from. Must not be empty
+ *
+ * @return The entry with the lowest priority
+ */
+HeapEntry heap_pop_min(IndexedHeap* self);
+
+/**
+ * @brief Checks whether the heap has no entries in it
+ *
+ * @param self Pointer to the heap to check
+ *
+ * @return True if the heap is empty, false otherwise
+ */
+bool heap_is_empty(IndexedHeap* self);
+
+/**
+ * @brief Removes every entry from the heap, taking time proportional to the number of entries rather than the capacity
+ *
+ * @param self Pointer to the heap to empty
+ */
+void heap_clear(IndexedHeap* self);
+
+/**
+ * @brief Frees the memory used by a heap
+ *
+ * @param self Pointer to the heap to delete
+ */
+void delete_indexed_heap(IndexedHeap* self);
+
+/**
+ * @struct bucketQueue
+ * @brief Represents a circular bucket queue of devices (Dial's algorithm) for small integer priorities
+ *
+ * Contains one doubly linked list of devices per bucket, stored as arrays indexed by device. A device with priority p is
+ * kept in bucket p % bucket_count. As long as every priority in the queue is within bucket_count - 1 of the lowest one,
+ * each bucket only ever holds devices with the same priority. Also contains the priority of each device, the number of
+ * devices in the queue and the bucket that the search for the lowest priority starts from.
+ */
+typedef struct bucketQueue {
+	int* bucket_heads;
+	int* next_in_bucket;
+	int* previous_in_bucket;
+	int* priorities;
+	bool* queued;
+	int bucket_count;
+	int current_bucket;
+	int size;
+} BucketQueue;
+
+/**
+ * @brief Creates a new, empty bucket queue that can hold devices 0 to capacity - 1
+ *
+ * @param capacity The number of devices the queue can hold
+ * @param max_step The largest amount that a priority can be above the lowest priority in the queue. For shortest path
+ *                 searches this is the largest link speed in the network
+ *
+ * @return The new bucket queue
+ */
+BucketQueue create_bucket_queue(int capacity, int max_step);
+
+/**
+ * @brief Inserts a device into the queue, or moves it to a lower priority if it is already in the queue
+ *
+ * @param self Pointer to the queue to insert into
+ * @param device The device to insert
+ * @param priority The new priority of the device. Must not be more than max_step above the last popped priority
+ */
+void bucket_push_or_decrease(BucketQueue* self, int device, int priority);
+
+/**
+ * @brief Removes and returns a device with the lowest priority
+ *
+ * @param self Pointer to the queue to remove from. Must not be empty
+ *
+ * @return The entry with the lowest priority
+ */
+HeapEntry bucket_pop_min(BucketQueue* self);
+
+/**
+ * @brief Removes every device from the queue
+ *
+ * @param self Pointer to the queue to empty
+ */
+void bucket_clear(BucketQueue* self);
+
+/**
+ * @brief Frees the memory used by a bucket queue
+ *
+ * @param self Pointer to the queue to delete
+ */
+void delete_bucket_queue(BucketQueue* self);
+
+/**
+ * @brief Tests all of the functions within this file
+ */
+void test_priority_queue();
@@ -0,0 +1,289 @@
+// route_cache.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "network.h"
+#include "route_cache.h"
+
+
+// Creates a route cache for a network that holds as many trees as fit in the memory limit
+RouteCache* create_route_cache(Network* network, size_t memory_limit) {
+	RouteCache* new_cache = malloc(sizeof * new_cache); // The newly created cache
+	size_t tree_bytes = (sizeof(int)) * 2 * (network->vertices > 0 ? network->vertices : 1); // The size of one tree
+	size_t capacity = memory_limit / tree_bytes; // The number of trees that fit in the limit
+
+	if (capacity < 1) {
+		capacity = 1;
+	}
+	if (capacity > (size_t)network->vertices) {
+		capacity = network->vertices > 0 ? network->vertices : 1;
+	}
+
+	new_cache->capacity = (int)capacity;
+	new_cache->size = 0;
+	new_cache->vertices = network->vertices;
+	new_cache->slot_sources = malloc((sizeof(int)) * new_cache->capacity);
+	new_cache->source_slots = malloc((sizeof(int)) * network->vertices);
+	new_cache->newer_slots = malloc((sizeof(int)) * new_cache->capacity);
+	new_cache->older_slots = malloc((sizeof(int)) * new_cache->capacity);
+	new_cache->newest_slot = -1;
+	new_cache->oldest_slot = -1;
+	new_cache->first_hops = malloc(tree_bytes / 2 * new_cache->capacity);
+	new_cache->distances = malloc(tree_bytes / 2 * new_cache->capacity);
+	new_cache->scratch_ready = false;
+	new_cache->hits = 0;
+	new_cache->misses = 0;
+
+	for (int i = 0; i < network->vertices; i++) {
+		new_cache->source_slots[i] = -1;
+	}
+
+	return new_cache;
+}
+
+// Unlinks a used slot from the list of slots in order of use
+void unlink_route_cache_slot(RouteCache* self, int slot) {
+	if (self->newer_slots[slot] != -1) {
+		self->older_slots[self->newer_slots[slot]] = self->older_slots[slot];
+	}
+	else {
+		self->newest_slot = self->older_slots[slot];
+	}
+
+	if (self->older_slots[slot] != -1) {
+		self->newer_slots[self->older_slots[slot]] = self->newer_slots[slot];
+	}
+	else {
+		self->oldest_slot = self->newer_slots[slot];
+	}
+}
+
+// Puts a slot at the front of the list of slots in order of use, as the most recently used
+void push_route_cache_slot(RouteCache* self, int slot) {
+	self->newer_slots[slot] = -1;
+	self->older_slots[slot] = self->newest_slot;
+
+	if (self->newest_slot != -1) {
+		self->newer_slots[self->newest_slot] = slot;
+	}
+	else {
+		self->oldest_slot = slot;
+	}
+
+	self->newest_slot = slot;
+}
+
+// Finds the shortest path tree of a device and stores it in a slot, replacing the least recently used tree if every slot
+// is used. Returns the slot
+int add_route_cache_tree(Network* network, RouteCache* self, int device_index) {
+	int slot; // The slot the tree is stored in
+	int algorithm; // The algorithm used to find the tree
+
+	// Use a free slot if there is one, otherwise take the slot of the least recently used tree
+	if (self->size < self->capacity) {
+		slot = self->size;
+		self->size++;
+	}
+	else {
+		slot = self->oldest_slot;
+		unlink_route_cache_slot(self, slot);
+		self->source_slots[self->slot_sources[slot]] = -1;
+	}
+
+	// The working memory depends on the largest link speed, so it is only made once the links are known
+	freeze_network(network);
+	if (!self->scratch_ready) {
+		self->scratch = create_routing_scratch(network);
+		self->scratch.store_routes = false;
+		self->scratch_ready = true;
+	}
+
+	algorithm = network->max_speed <= BUCKET_QUEUE_MAX_SPEED ? ALGORITHM_DIJKSTRA_BUCKETS : ALGORITHM_DIJKSTRA_HEAP;
+	find_shortest_paths(network, device_index, algorithm, &self->scratch);
+
+	memcpy(&self->first_hops[(size_t)slot * self->vertices], self->scratch.first_hops, (sizeof(int)) * self->vertices);
+	memcpy(&self->distances[(size_t)slot * self->vertices], self->scratch.distances, (sizeof(int)) * self->vertices);
+
+	self->slot_sources[slot] = device_index;
+	self->source_slots[device_index] = slot;
+	push_route_cache_slot(self, slot);
+
+	return slot;
+}
+
+// Sets how much memory a network's route cache can use, replacing the cache with an empty one
+void set_route_cache_limit(Network* self, size_t memory_limit) {
+	delete_route_cache(self);
+	self->route_cache = create_route_cache(self, memory_limit);
+}
+
+// Returns the route from one device to another, finding and caching the first device's shortest path tree if needed
+Route get_route(Network* self, int from_device, int to_device) {
+	RouteCache* cache; // The network's route cache
+	Route route; // The route that was found
+	int slot; // The slot that holds the tree of the first device
+	size_t index; // The index of the second device in the tree
+
+	if (self->route_cache == NULL) {
+		self->route_cache = create_route_cache(self, ROUTE_CACHE_DEFAULT_LIMIT);
+	}
+	cache = self->route_cache;
+
+	// The trees are stored by internal index
+	from_device = to_internal_id(self, from_device);
+	to_device = to_internal_id(self, to_device);
+
+	slot = cache->source_slots[from_device];
+	if (slot != -1) {
+		cache->hits++;
+
+		// Move the tree to the front of the list, unless it is already there
+		if (slot != cache->newest_slot) {
+			unlink_route_cache_slot(cache, slot);
+			push_route_cache_slot(cache, slot);
+		}
+	}
+	else {
+		cache->misses++;
+		slot = add_route_cache_tree(self, cache, from_device);
+	}
+
+	index = (size_t)slot * cache->vertices + to_device;
+	route.next_hop = to_external_id(self, cache->first_hops[index]);
+	route.cost = route.next_hop != -1 ? cache->distances[index] : -1;
+
+	return route;
+}
+
+// Removes every tree from a network's route cache. The working memory is deleted too, as the largest link speed may change
+void clear_route_cache(Network* self) {
+	RouteCache* cache = self->route_cache; // The network's route cache
+
+	if (cache == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < cache->size; i++) {
+		cache->source_slots[cache->slot_sources[i]] = -1;
+	}
+	cache->size = 0;
+	cache->newest_slot = -1;
+	cache->oldest_slot = -1;
+
+	if (cache->scratch_ready) {
+		delete_routing_scratch(&cache->scratch);
+		cache->scratch_ready = false;
+	}
+}
+
+// Frees the memory used by a network's route cache
+void delete_route_cache(Network* self) {
+	RouteCache* cache = self->route_cache; // The network's route cache
+
+	if (cache == NULL) {
+		return;
+	}
+
+	clear_route_cache(self);
+	free(cache->slot_sources);
+	free(cache->source_slots);
+	free(cache->newer_slots);
+	free(cache->older_slots);
+	free(cache->first_hops);
+	free(cache->distances);
+	free(cache);
+	self->route_cache = NULL;
+}
+
+void test_route_cache() {
+	// Note about testing unlink_route_cache_slot, push_route_cache_slot and add_route_cache_tree: These are helper
+	// functions that are called by every query. Each of the tests below relies on them, so they do not need to be tested
+	// separately. The same is true for create_route_cache, which is called by set_route_cache_limit.
+
+	const String TEST_FILE_PATH = "test_graph.txt"; // The path of the file containing the test network
+	Network* testing_network = build_network_from_file(TEST_FILE_PATH); // The network used for testing this file
+	Route route; // The most recently found route
+
+	printf("\n------------------------------------------------------\n                *route_cache.c tests*\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 1 - Test get_route()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n1. get_route() test\n----------------\n");
+
+	// 1.1 - Test a query when the network has no route cache. A cache with the default limit should be made, and the
+	//		 tree of device 0 found without building any routing tables
+	route = get_route(testing_network, 0, 1);
+
+	printf("1.1 - Expected Result: cost 6, next hop 3, 5 trees, routing tables not built\n1.1 - Actual Result: ");
+	printf(
+		"cost %d, next hop %d, %d trees, routing tables %s\n",
+		route.cost,
+		route.next_hop,
+		testing_network->route_cache->capacity,
+		testing_network->routes_allocated ? "built" : "not built"
+	);
+
+	// 1.2 - Test a second query from the same device. It should be answered from the cache
+	route = get_route(testing_network, 0, 4);
+
+	printf("1.2 - Expected Result: cost 4, next hop 3, 1 hit, 1 miss\n1.2 - Actual Result: ");
+	printf(
+		"cost %d, next hop %d, %lld hit, %lld miss\n",
+		route.cost,
+		route.next_hop,
+		testing_network->route_cache->hits,
+		testing_network->route_cache->misses
+	);
+
+	// 1.3 - Test a query from a device to itself
+	route = get_route(testing_network, 2, 2);
+
+	printf("1.3 - Expected Result: cost -1, next hop -1\n1.3 - Actual Result: ");
+	printf("cost %d, next hop %d\n", route.cost, route.next_hop);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 2 - Test set_route_cache_limit()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n2. set_route_cache_limit() test\n----------------\n");
+
+	// 2.1 - Test a limit that fits two trees of 5 devices (40 bytes each). Querying devices 0, 1, 0 and then 2 should
+	//		 replace the tree of device 1, as device 0 was used more recently
+	set_route_cache_limit(testing_network, 80);
+	get_route(testing_network, 0, 1);
+	get_route(testing_network, 1, 0);
+	get_route(testing_network, 0, 2);
+	get_route(testing_network, 2, 0);
+
+	printf("2.1 - Expected Result: 2 trees, devices 0 and 2 cached, device 1 not cached\n2.1 - Actual Result: ");
+	printf(
+		"%d trees, devices 0 and 2 %s, device 1 %s\n",
+		testing_network->route_cache->capacity,
+		testing_network->route_cache->source_slots[0] != -1 && testing_network->route_cache->source_slots[2] != -1
+			? "cached" : "not cached",
+		testing_network->route_cache->source_slots[1] != -1 ? "cached" : "not cached"
+	);
+
+	// 2.2 - Test a limit that is too small for one tree. One tree should still be kept
+	set_route_cache_limit(testing_network, 1);
+
+	printf("2.2 - Expected Result: 1 tree\n2.2 - Actual Result: %d tree\n", testing_network->route_cache->capacity);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 3 - Test clear_route_cache()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n3. clear_route_cache() test\n----------------\n");
+
+	// 3.1 - Test adding a link after a query. The cache should be cleared so that the next query sees the new link
+	get_route(testing_network, 0, 1);
+	add_link(testing_network, 0, 1, 1);
+	route = get_route(testing_network, 0, 1);
+
+	printf("3.1 - Expected Result: cost 1, next hop 1, 2 misses\n3.1 - Actual Result: ");
+	printf("cost %d, next hop %d, %lld misses\n", route.cost, route.next_hop, testing_network->route_cache->misses);
+
+	// Free memory
+	delete_network(testing_network);
+}
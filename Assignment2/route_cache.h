@@ -0,0 +1,80 @@
+// route_cache.h
+#pragma once
+
+#include <stddef.h>
+
+#include "network.h"
+
+// The memory limit of a network's route cache when get_route() is called before set_route_cache_limit() (64 MiB)
+#define ROUTE_CACHE_DEFAULT_LIMIT ((size_t)64 * 1024 * 1024)
+
+/**
+ * @struct routeCache
+ * @brief Represents a least recently used cache of shortest path trees, each found from one source device
+ *
+ * Contains a fixed number of slots, each holding the first hop and distance from one source device to every device. The
+ * first hops and distances of slot i are at index i * vertices in the two slab arrays. The slot each device's tree is in
+ * (-1 if it is not cached) and the source device of each slot are kept, as well as a doubly linked list of the used slots
+ * from the most to the least recently used, stored as arrays indexed by slot. When every slot is used, the least recently
+ * used tree is replaced. Also contains the working memory used to find new trees, which is made on the first search
+ * after the cache is made or cleared (scratch_ready), and counts of the queries answered with and without a search.
+ */
+typedef struct routeCache {
+	int capacity;
+	int size;
+	int vertices;
+	int* slot_sources;
+	int* source_slots;
+	int* newer_slots;
+	int* older_slots;
+	int newest_slot;
+	int oldest_slot;
+	int* first_hops;
+	int* distances;
+	RoutingScratch scratch;
+	bool scratch_ready;
+	long long hits;
+	long long misses;
+} RouteCache;
+
+/**
+ * @brief Sets how much memory a network's route cache can use for shortest path trees, emptying the cache. At least one
+ *        tree is always kept, and never more than one for each device
+ *
+ * @param self The network to set the route cache limit of
+ * @param memory_limit The number of bytes the trees can take up. Each tree takes 8 bytes for each device
+ */
+void set_route_cache_limit(Network* self, size_t memory_limit);
+
+/**
+ * @brief Gets the route from one device to another, finding the shortest path tree of the first device if it is not in
+ *        the route cache. Only the trees of devices that are queried are ever found, so the full routing tables are never
+ *        built. Not safe to call from several threads at once
+ *
+ * @param self The network the devices are in
+ * @param from_device The device the route starts at
+ * @param to_device The device the route goes to
+ *
+ * @return The route, with a next hop and cost of -1 if there is no route or the devices are the same
+ */
+Route get_route(Network* self, int from_device, int to_device);
+
+/**
+ * @brief Removes every tree from a network's route cache, which is done whenever the network's links change. Does nothing
+ *        if the network has no route cache
+ *
+ * @param self The network to clear the route cache of
+ */
+void clear_route_cache(Network* self);
+
+/**
+ * @brief Frees the memory used by a network's route cache. Does nothing if the network has no route cache
+ *
+ * @param self The network to delete the route cache of
+ */
+void delete_route_cache(Network* self);
+
+/**
+ * @brief Tests all of the functions within this file
+ */
+void test_route_cache();
@@ -0,0 +1,233 @@
+// route_query.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <stdbool.h>
+
+#include "network.h"
+#include "priority_queue.h"
+#include "route_query.h"
+
+
+// Creates and returns the working memory needed to find routes between two devices in a network
+BidirectionalSearch create_bidirectional_search(Network* network) {
+	BidirectionalSearch new_search; // The newly created working memory
+
+	new_search.forward_distances = malloc((sizeof(int)) * network->vertices);
+	new_search.backward_distances = malloc((sizeof(int)) * network->vertices);
+	new_search.forward_first_hops = malloc((sizeof(int)) * network->vertices);
+	new_search.forward_heap = create_indexed_heap(network->vertices);
+	new_search.backward_heap = create_indexed_heap(network->vertices);
+
+	// A device can be touched once from each side
+	new_search.touched_devices = malloc((sizeof(int)) * 2 * network->vertices);
+	new_search.touched_count = 0;
+	new_search.settled_count = 0;
+
+	for (int i = 0; i < network->vertices; i++) {
+		new_search.forward_distances[i] = INT_MAX;
+		new_search.backward_distances[i] = INT_MAX;
+		new_search.forward_first_hops[i] = -1;
+	}
+
+	return new_search;
+}
+
+// Resets the distances and first hops of every device that the last query touched, and empties both heaps
+void reset_bidirectional_search(BidirectionalSearch* self) {
+	for (int i = 0; i < self->touched_count; i++) {
+		self->forward_distances[self->touched_devices[i]] = INT_MAX;
+		self->backward_distances[self->touched_devices[i]] = INT_MAX;
+		self->forward_first_hops[self->touched_devices[i]] = -1;
+	}
+
+	self->touched_count = 0;
+	heap_clear(&self->forward_heap);
+	heap_clear(&self->backward_heap);
+}
+
+// Finds the route between two devices by searching forwards from the first and backwards from the second at once
+Route find_route_bidirectional(Network* self, int from_device, int to_device, BidirectionalSearch* search) {
+	Route route = { -1, -1 }; // The route that was found
+	long long best_cost = LLONG_MAX; // The cost of the shortest route found so far where the two sides meet
+	int best_first_hop = -1; // The first hop of the shortest route found so far
+	bool forward; // Whether the forward side is being expanded
+	IndexedHeap* heap; // The heap of the side being expanded
+	int* distances; // The distances of the side being expanded
+	int* other_distances; // The distances of the other side
+	int current_device; // The currently assessed device
+	int to; // The device the current link goes to
+	Link* current_link;
+
+	search->settled_count = 0;
+	if (from_device == to_device) {
+		return route;
+	}
+
+	freeze_network(self);
+	from_device = to_internal_id(self, from_device);
+	to_device = to_internal_id(self, to_device);
+
+	search->forward_distances[from_device] = 0;
+	search->backward_distances[to_device] = 0;
+	search->touched_devices[0] = from_device;
+	search->touched_devices[1] = to_device;
+	search->touched_count = 2;
+	heap_push_or_decrease(&search->forward_heap, from_device, 0);
+	heap_push_or_decrease(&search->backward_heap, to_device, 0);
+
+	// If either side runs out of devices, every device it can reach has been settled, so no shorter route can be found
+	while (!heap_is_empty(&search->forward_heap) && !heap_is_empty(&search->backward_heap)) {
+		// Any route not found yet is at least as long as the closest waiting device of each side added together
+		if ((long long)search->forward_heap.entries[0].priority + search->backward_heap.entries[0].priority >= best_cost) {
+			break;
+		}
+
+		forward = search->forward_heap.size <= search->backward_heap.size;
+		heap = forward ? &search->forward_heap : &search->backward_heap;
+		distances = forward ? search->forward_distances : search->backward_distances;
+		other_distances = forward ? search->backward_distances : search->forward_distances;
+
+		current_device = heap_pop_min(heap).device;
+		search->settled_count++;
+
+		for (int i = self->link_offsets[current_device]; i < self->link_offsets[current_device + 1]; i++) {
+			current_link = &self->packed_links[i];
+			to = current_link->to_device;
+
+			// Check whether the sides meet across this link, and keep the first hop of the route if it is the shortest yet
+			if (
+				other_distances[to] != INT_MAX &&
+				(long long)distances[current_device] + current_link->speed + other_distances[to] < best_cost
+			) {
+				best_cost = (long long)distances[current_device] + current_link->speed + other_distances[to];
+
+				// Going forwards the route is the first device to current_device then to. Going backwards it is the first
+				// device to to then current_device
+				if (forward) {
+					best_first_hop = current_device == from_device ? to : search->forward_first_hops[current_device];
+				}
+				else {
+					best_first_hop = to == from_device ? current_device : search->forward_first_hops[to];
+				}
+			}
+
+			if (distances[current_device] + current_link->speed < distances[to]) {
+				if (distances[to] == INT_MAX) {
+					search->touched_devices[search->touched_count] = to;
+					search->touched_count++;
+				}
+
+				distances[to] = distances[current_device] + current_link->speed;
+				heap_push_or_decrease(heap, to, distances[to]);
+
+				// Devices linked to the first device are their own first hop, the rest share the first hop of the device before them
+				if (forward) {
+					if (current_device == from_device) {
+						search->forward_first_hops[to] = to;
+					}
+					else {
+						search->forward_first_hops[to] = search->forward_first_hops[current_device];
+					}
+				}
+			}
+		}
+	}
+
+	if (best_cost != LLONG_MAX) {
+		route.next_hop = to_external_id(self, best_first_hop);
+		route.cost = (int)best_cost;
+	}
+
+	reset_bidirectional_search(search);
+
+	return route;
+}
+
+// Frees the working memory used to find routes between two devices
+void delete_bidirectional_search(BidirectionalSearch* self) {
+	free(self->forward_distances);
+	free(self->backward_distances);
+	free(self->forward_first_hops);
+	free(self->touched_devices);
+	delete_indexed_heap(&self->forward_heap);
+	delete_indexed_heap(&self->backward_heap);
+	self->forward_distances = NULL;
+	self->backward_distances = NULL;
+	self->forward_first_hops = NULL;
+	self->touched_devices = NULL;
+}
+
+void test_route_query() {
+	// Note about testing reset_bidirectional_search: This is a helper function that is called at the end of every query.
+	// Each query after the first relies on it, so it does not need to be tested separately.
+
+	const String TEST_FILE_PATH = "test_graph.txt"; // The path of the file containing the test network
+	const String LARGE_FILE_PATH = "devices_1000_avgdegree_5.0_large_network.txt"; // The path of a larger network
+	Network* testing_network = build_network_from_file(TEST_FILE_PATH); // The network used for testing this file
+	Network* large_network = build_network_from_file(LARGE_FILE_PATH); // A larger network to count settled devices in
+	BidirectionalSearch search = create_bidirectional_search(testing_network); // The working memory for the test network
+	BidirectionalSearch large_search = create_bidirectional_search(large_network); // The working memory for the larger network
+	Route route; // The most recently found route
+	int differences = 0; // The number of routes that differ from the routing tables
+	long long settled_devices = 0; // The number of devices settled over every query on the larger network
+
+	printf("\n------------------------------------------------------\n                *route_query.c tests*\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 1 - Test find_route_bidirectional()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n1. find_route_bidirectional() test\n----------------\n");
+
+	// 1.1 - Test a route whose sides meet in the middle. 0 to 1 goes through 3 and 2
+	route = find_route_bidirectional(testing_network, 0, 1, &search);
+
+	printf("1.1 - Expected Result: cost 6, next hop 3\n1.1 - Actual Result: ");
+	printf("cost %d, next hop %d\n", route.cost, route.next_hop);
+
+	// 1.2 - Test a route where the backward side reaches the first device, so the next hop is found from the backward side
+	route = find_route_bidirectional(testing_network, 4, 2, &search);
+
+	printf("1.2 - Expected Result: cost 2, next hop 2\n1.2 - Actual Result: ");
+	printf("cost %d, next hop %d\n", route.cost, route.next_hop);
+
+	// 1.3 - Test a route from a device to itself
+	route = find_route_bidirectional(testing_network, 3, 3, &search);
+
+	printf("1.3 - Expected Result: cost -1, next hop -1\n1.3 - Actual Result: ");
+	printf("cost %d, next hop %d\n", route.cost, route.next_hop);
+
+	// 1.4 - Test a route between devices that are not connected
+	delete_network(testing_network);
+	testing_network = create_network(3);
+	add_link(testing_network, 0, 1, 2);
+	route = find_route_bidirectional(testing_network, 0, 2, &search);
+
+	printf("1.4 - Expected Result: cost -1, next hop -1\n1.4 - Actual Result: ");
+	printf("cost %d, next hop %d\n", route.cost, route.next_hop);
+
+	// 1.5 - Test every route from device 0 of a larger network against its routing table. The searches together should
+	//		 settle fewer devices than searching the whole network for each route would
+	build_routing_tables(large_network, ALGORITHM_DIJKSTRA_HEAP);
+	for (int i = 1; i < large_network->vertices; i++) {
+		route = find_route_bidirectional(large_network, 0, i, &large_search);
+		settled_devices += large_search.settled_count;
+
+		if (route.cost != get_route_cost(large_network, 0, i)) {
+			differences++;
+		}
+	}
+
+	printf("1.5 - Expected Result: 0 costs differ, fewer devices settled than a full search\n1.5 - Actual Result: ");
+	printf(
+		"%d costs differ, %s devices settled than a full search\n",
+		differences,
+		settled_devices < (long long)large_network->vertices * (large_network->vertices - 1) ? "fewer" : "no fewer"
+	);
+
+	// Free memory
+	delete_bidirectional_search(&search);
+	delete_bidirectional_search(&large_search);
+	delete_network(testing_network);
+	delete_network(large_network);
+}
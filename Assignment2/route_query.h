@@ -0,0 +1,61 @@
+// route_query.h
+#pragma once
+
+#include "network.h"
+#include "priority_queue.h"
+
+/**
+ * @struct bidirectionalSearch
+ * @brief Represents the working memory used to find the route between two devices by searching from both of them at once
+ *
+ * Contains the distances found by the search forwards from the first device and backwards from the second device, the
+ * first hop from the first device to each device reached forwards, a heap for each direction, and a list of the devices
+ * whose distances have been set so that only those are reset after each query. Also contains the number of devices that
+ * the last query settled, counting both directions.
+ */
+typedef struct bidirectionalSearch {
+	int* forward_distances;
+	int* backward_distances;
+	int* forward_first_hops;
+	IndexedHeap forward_heap;
+	IndexedHeap backward_heap;
+	int* touched_devices;
+	int touched_count;
+	int settled_count;
+} BidirectionalSearch;
+
+/**
+ * @brief Creates the working memory needed to find routes between two devices in a network
+ *
+ * @param network The network the working memory is for
+ *
+ * @return The new working memory
+ */
+BidirectionalSearch create_bidirectional_search(Network* network);
+
+/**
+ * @brief Finds the route between two devices with Dijkstra's algorithm run forwards from the first device and backwards
+ *        from the second device at once, using the side with fewer devices waiting each time. Links go both ways, so the
+ *        backward search uses the same links. The search stops once the closest waiting devices of the two sides are
+ *        together at least as far as the shortest route found where the sides meet. The network is frozen first
+ *
+ * @param self The network the devices are in
+ * @param from_device The device the route starts at
+ * @param to_device The device the route goes to
+ * @param search Pointer to the working memory to use
+ *
+ * @return The route, with a next hop and cost of -1 if there is no route or the devices are the same
+ */
+Route find_route_bidirectional(Network* self, int from_device, int to_device, BidirectionalSearch* search);
+
+/**
+ * @brief Frees the working memory used to find routes between two devices
+ *
+ * @param self Pointer to the working memory to delete
+ */
+void delete_bidirectional_search(BidirectionalSearch* self);
+
+/**
+ * @brief Tests all of the functions within this file
+ */
+void test_route_query();
@@ -0,0 +1,498 @@
+// topology.c
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "network.h"
+#include "topology.h"
+
+
+// Mixes a seed into a well spread 64-bit value (splitmix64), so that similar seeds give unrelated states
+uint64_t mix_seed(uint64_t seed) {
+	uint64_t mixed = seed + 0x9E3779B97F4A7C15ULL; // The seed as it is mixed
+
+	mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+
+	return mixed ^ (mixed >> 31);
+}
+
+// Gets the next random number from a generator (xorshift64*)
+uint64_t next_random(TopologyGenerator* self) {
+	self->random_state ^= self->random_state >> 12;
+	self->random_state ^= self->random_state << 25;
+	self->random_state ^= self->random_state >> 27;
+
+	return self->random_state * 0x2545F4914F6CDD1DULL;
+}
+
+// Gets a random number from 0 up to (not including) a bound, by scaling the top 32 bits rather than taking a remainder
+int random_below(TopologyGenerator* self, int bound) {
+	return (int)(((next_random(self) >> 32) * (uint64_t)bound) >> 32);
+}
+
+// Picks the speed of a new link, with the same chances as network_maker.py
+int random_speed(TopologyGenerator* self) {
+	int roll = random_below(self, 10); // A random number from 0 to 9
+
+	if (roll < 1) {
+		return 1;
+	}
+	if (roll < 4) {
+		return 2;
+	}
+	if (roll < 8) {
+		return 4;
+	}
+	return 8;
+}
+
+// Adds the link between two devices to the set of links made, returning false if they are already linked. Each link is
+// keyed by its lower device and then its higher device, plus 1 so that no key is 0
+bool add_link_key(TopologyGenerator* self, int first_device, int second_device) {
+	uint64_t key; // The key of the link
+	size_t slot; // The slot in the set that is being checked
+
+	if (first_device > second_device) {
+		key = (uint64_t)second_device * self->vertices + first_device + 1;
+	}
+	else {
+		key = (uint64_t)first_device * self->vertices + second_device + 1;
+	}
+
+	slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (self->link_key_capacity - 1);
+	while (self->link_keys[slot] != 0) {
+		if (self->link_keys[slot] == key) {
+			return false;
+		}
+		slot = (slot + 1) & (self->link_key_capacity - 1);
+	}
+
+	self->link_keys[slot] = key;
+	return true;
+}
+
+// Creates a generator, allocating the memory that its shape needs
+TopologyGenerator create_topology_generator(TopologyShape shape, int vertices, double average_degree, uint64_t seed) {
+	TopologyGenerator new_generator; // The new generator
+	long long most_links = (long long)vertices * (vertices - 1) / 2; // The number of links when every device is linked to every other
+	int swap_index; // The index of the device that the current device is swapped with while shuffling
+	int swapped_device; // The device being swapped
+
+	new_generator.shape = shape;
+	new_generator.vertices = vertices;
+	new_generator.links_made = 0;
+	new_generator.random_state = mix_seed(seed);
+	new_generator.devices = NULL;
+	new_generator.device_count = 0;
+	new_generator.link_keys = NULL;
+	new_generator.link_key_capacity = 0;
+	new_generator.attached = NULL;
+	new_generator.attachment_count = 0;
+	new_generator.next_device = 1;
+	new_generator.next_attachment = 0;
+	new_generator.grid_width = 1;
+
+	// xorshift never leaves a state of 0
+	if (new_generator.random_state == 0) {
+		new_generator.random_state = 1;
+	}
+
+	if (shape == TOPOLOGY_GRID) {
+		new_generator.next_device = 0;
+		while ((long long)new_generator.grid_width * new_generator.grid_width < vertices) {
+			new_generator.grid_width++;
+		}
+
+		// Every device but the last of each row links to the one beside it, and every device but those of the last row
+		// links to the one below it
+		new_generator.link_target = vertices - (vertices + new_generator.grid_width - 1) / new_generator.grid_width;
+		if (vertices > new_generator.grid_width) {
+			new_generator.link_target += vertices - new_generator.grid_width;
+		}
+	}
+	else if (shape == TOPOLOGY_POWER_LAW) {
+		new_generator.attachment_count = (int)(average_degree / 2 + 0.5);
+		if (new_generator.attachment_count < 1) {
+			new_generator.attachment_count = 1;
+		}
+
+		new_generator.link_target = 0;
+		for (int i = 1; i < vertices; i++) {
+			new_generator.link_target += i < new_generator.attachment_count ? i : new_generator.attachment_count;
+		}
+
+		new_generator.devices = malloc((sizeof(int)) * (size_t)(2 * new_generator.link_target + 1));
+		new_generator.attached = malloc((sizeof(int)) * new_generator.attachment_count);
+	}
+	else {
+		// The spanning tree needs a link for each device but the first, and there cannot be more links than pairs of devices
+		new_generator.link_target = (long long)(vertices * average_degree / 2);
+		if (new_generator.link_target < vertices - 1) {
+			new_generator.link_target = vertices - 1;
+		}
+		if (new_generator.link_target > most_links) {
+			new_generator.link_target = most_links;
+		}
+
+		new_generator.devices = malloc((sizeof(int)) * (vertices > 0 ? vertices : 1));
+		for (int i = 0; i < vertices; i++) {
+			new_generator.devices[i] = i;
+		}
+		for (int i = vertices - 1; i > 0; i--) {
+			swap_index = random_below(&new_generator, i + 1);
+			swapped_device = new_generator.devices[i];
+			new_generator.devices[i] = new_generator.devices[swap_index];
+			new_generator.devices[swap_index] = swapped_device;
+		}
+
+		// Keep the set at most half full so that few slots are checked for each link
+		new_generator.link_key_capacity = 16;
+		while (new_generator.link_key_capacity < 2 * (size_t)new_generator.link_target) {
+			new_generator.link_key_capacity *= 2;
+		}
+		new_generator.link_keys = calloc(new_generator.link_key_capacity, sizeof * new_generator.link_keys);
+	}
+
+	return new_generator;
+}
+
+// Makes the next link of a random network. The spanning tree is made first, then random pairs of devices are linked until
+// there are enough links, skipping pairs that are the same device or are already linked
+bool next_random_link(TopologyGenerator* self, int* first_device, int* second_device) {
+	if (self->links_made >= self->link_target) {
+		return false;
+	}
+
+	if (self->next_device < self->vertices) {
+		*first_device = self->devices[self->next_device];
+		*second_device = self->devices[random_below(self, self->next_device)];
+		self->next_device++;
+
+		add_link_key(self, *first_device, *second_device);
+		return true;
+	}
+
+	do {
+		*first_device = random_below(self, self->vertices);
+		*second_device = random_below(self, self->vertices);
+	} while (*first_device == *second_device || !add_link_key(self, *first_device, *second_device));
+
+	return true;
+}
+
+// Makes the next link of a grid. Each device links to the device beside it and then to the device below it
+bool next_grid_link(TopologyGenerator* self, int* first_device, int* second_device) {
+	while (self->next_device < self->vertices) {
+		*first_device = self->next_device;
+
+		if (self->next_attachment == 0) {
+			self->next_attachment = 1;
+
+			if ((self->next_device + 1) % self->grid_width != 0 && self->next_device + 1 < self->vertices) {
+				*second_device = self->next_device + 1;
+				return true;
+			}
+		}
+		else {
+			self->next_attachment = 0;
+			self->next_device++;
+
+			if (*first_device + self->grid_width < self->vertices) {
+				*second_device = *first_device + self->grid_width;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// Makes the next link of a power law network. Each device is linked to every earlier device while there are no more of
+// them than it has links to make. After that, it is linked to the device at a random end of a random earlier link, which
+// picks devices with more links more often, trying again if it picks itself or a device it is already linked to
+bool next_power_law_link(TopologyGenerator* self, int* first_device, int* second_device) {
+	bool repeated; // Whether the picked device has already been linked to the current device
+
+	while (self->next_device < self->vertices) {
+		if (self->next_attachment < self->attachment_count && self->next_attachment < self->next_device) {
+			*first_device = self->next_device;
+
+			if (self->next_device <= self->attachment_count) {
+				*second_device = self->next_attachment;
+			}
+			else {
+				do {
+					*second_device = self->devices[random_below(self, (int)self->device_count)];
+
+					repeated = *second_device == *first_device;
+					for (int i = 0; i < self->next_attachment && !repeated; i++) {
+						repeated = self->attached[i] == *second_device;
+					}
+				} while (repeated);
+			}
+
+			self->attached[self->next_attachment] = *second_device;
+			self->next_attachment++;
+			self->devices[self->device_count] = *first_device;
+			self->devices[self->device_count + 1] = *second_device;
+			self->device_count += 2;
+			return true;
+		}
+
+		self->next_device++;
+		self->next_attachment = 0;
+	}
+
+	return false;
+}
+
+// Makes the next link of a network, with a random speed
+bool next_topology_link(TopologyGenerator* self, int* first_device, int* second_device, int* speed) {
+	bool made; // Whether a link was made
+
+	if (self->shape == TOPOLOGY_GRID) {
+		made = next_grid_link(self, first_device, second_device);
+	}
+	else if (self->shape == TOPOLOGY_POWER_LAW) {
+		made = next_power_law_link(self, first_device, second_device);
+	}
+	else {
+		made = next_random_link(self, first_device, second_device);
+	}
+
+	if (!made) {
+		return false;
+	}
+
+	*speed = random_speed(self);
+	self->links_made++;
+	return true;
+}
+
+// Frees the memory used by a generator
+void delete_topology_generator(TopologyGenerator* self) {
+	free(self->devices);
+	free(self->link_keys);
+	free(self->attached);
+
+	self->devices = NULL;
+	self->link_keys = NULL;
+	self->attached = NULL;
+}
+
+// Generates a network by collecting every link from a generator, then packing them all at once
+Network* generate_network(TopologyShape shape, int vertices, double average_degree, uint64_t seed) {
+	TopologyGenerator generator = create_topology_generator(shape, vertices, average_degree, seed); // The link generator
+	int link_capacity = generator.link_target > 0 ? (int)generator.link_target : 1; // The number of links there is room for
+	int* first_devices = malloc((sizeof(int)) * link_capacity); // The device at one end of each link
+	int* second_devices = malloc((sizeof(int)) * link_capacity); // The device at the other end of each link
+	int* speeds = malloc((sizeof(int)) * link_capacity); // The speed of each link
+	int link_count = 0; // The number of links made
+	Network* new_network; // The new network
+
+	while (
+		link_count < link_capacity &&
+		next_topology_link(&generator, &first_devices[link_count], &second_devices[link_count], &speeds[link_count])
+	) {
+		link_count++;
+	}
+
+	new_network = build_network_from_links(vertices, link_count, first_devices, second_devices, speeds);
+
+	delete_topology_generator(&generator);
+	free(first_devices);
+	free(second_devices);
+	free(speeds);
+
+	return new_network;
+}
+
+// Generates a network into a text network file, writing each link as soon as it is made
+bool save_generated_network(TopologyShape shape, int vertices, double average_degree, uint64_t seed, String filepath) {
+	TopologyGenerator generator; // The link generator
+	FILE* file; // The file to write to
+	bool written; // Whether every line was written
+	int first_device; // The device at one end of the current link
+	int second_device; // The device at the other end of the current link
+	int speed; // The speed of the current link
+
+	file = fopen(filepath, "w");
+	if (file == NULL) {
+		printf("Error opening file!\n");
+		return false;
+	}
+
+	generator = create_topology_generator(shape, vertices, average_degree, seed);
+
+	written = fprintf(file, "%d", vertices) > 0;
+	while (written && next_topology_link(&generator, &first_device, &second_device, &speed)) {
+		written = fprintf(file, "\n%d,%d,%d", first_device, second_device, speed) > 0;
+	}
+
+	if (fclose(file) != 0) {
+		written = false;
+	}
+	delete_topology_generator(&generator);
+
+	return written;
+}
+
+// Gets the name of a topology shape
+String get_topology_name(TopologyShape shape) {
+	const String NAMES[] = { "random", "grid", "power_law" }; // The name of each shape, in the order of TopologyShape
+
+	if (shape < TOPOLOGY_RANDOM || shape > TOPOLOGY_POWER_LAW) {
+		return "unknown";
+	}
+
+	return NAMES[shape];
+}
+
+// Counts the links of a network that go from a device to itself or repeat an earlier link of the same device
+int count_repeated_links(Network* self) {
+	int repeated = 0; // The number of links that are repeated or go nowhere
+
+	for (int i = 0; i < self->vertices; i++) {
+		for (int j = self->link_offsets[i]; j < self->link_offsets[i + 1]; j++) {
+			if (self->packed_links[j].to_device == i) {
+				repeated++;
+			}
+			for (int k = self->link_offsets[i]; k < j; k++) {
+				if (self->packed_links[k].to_device == self->packed_links[j].to_device) {
+					repeated++;
+				}
+			}
+		}
+	}
+
+	return repeated;
+}
+
+void test_topology() {
+	// Note about testing the generators of each shape and the random number functions: next_topology_link() calls them for
+	// every link, and generate_network() and save_generated_network() call it, so they are tested by the tests below.
+
+	const String GENERATED_FILE_PATH = "generated_network.txt"; // The path of the file that a generated network is written to
+	Network* generated_network = generate_network(TOPOLOGY_RANDOM, 100, 5.0, 42); // The network being tested
+	Network* other_network; // A network to compare against the one being tested
+	int differences; // The number of links that differ between the networks
+	int largest_degree; // The most links that any device has
+
+	printf("\n------------------------------------------------------\n                  *topology.c tests*\n");
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 1 - Test generate_network()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n1. generate_network() test\n----------------\n");
+
+	// 1.1 - Test generating a network twice with the same seed, then with another seed. The same seed should give the same
+	//		 links, and another seed should give different ones
+	other_network = generate_network(TOPOLOGY_RANDOM, 100, 5.0, 42);
+
+	differences = 0;
+	for (int i = 0; i < generated_network->link_count; i++) {
+		if (
+			generated_network->packed_links[i].to_device != other_network->packed_links[i].to_device ||
+			generated_network->packed_links[i].speed != other_network->packed_links[i].speed
+		) {
+			differences++;
+		}
+	}
+	printf("1.1 - Expected Result: 0 differences with the same seed, some with another\n1.1 - Actual Result: ");
+	printf("%d differences with the same seed, ", differences);
+
+	delete_network(other_network);
+	other_network = generate_network(TOPOLOGY_RANDOM, 100, 5.0, 43);
+
+	differences = 0;
+	for (int i = 0; i < generated_network->link_count; i++) {
+		if (generated_network->packed_links[i].to_device != other_network->packed_links[i].to_device) {
+			differences++;
+		}
+	}
+	printf("%s with another\n", differences > 0 ? "some" : "none");
+
+	// 1.2 - Test a larger random network. It should have the number of links that its average degree asks for, be connected
+	//		 and have no repeated links or links from a device to itself
+	delete_network(generated_network);
+	generated_network = generate_network(TOPOLOGY_RANDOM, 1000, 2.3, 1);
+
+	printf("1.2 - Expected Result: 1150 links, 1 component, 0 repeated links, max speed 8\n");
+	printf(
+		"1.2 - Actual Result: %d links, %d component, %d repeated links, max speed %d\n",
+		generated_network->link_count / 2,
+		generated_network->component_count,
+		count_repeated_links(generated_network),
+		generated_network->max_speed
+	);
+
+	// 1.3 - Test a grid of 10 devices, which has rows of 4. Device 5 is linked to the devices beside, above and below it
+	delete_network(generated_network);
+	generated_network = generate_network(TOPOLOGY_GRID, 10, 4.0, 1);
+
+	printf("1.3 - Expected Result: 13 links, 1 component, device 5 links 9 6 4 1\n1.3 - Actual Result: ");
+	printf("%d links, %d component, device 5 links", generated_network->link_count / 2, generated_network->component_count);
+	for (int i = generated_network->link_offsets[5]; i < generated_network->link_offsets[6]; i++) {
+		printf(" %d", generated_network->packed_links[i].to_device);
+	}
+	printf("\n");
+
+	// 1.4 - Test a power law network with an average degree of 4. Device 1 links to device 0, and every later device links
+	//		 to 2 earlier ones. Devices that were linked to early should have many more links than the average
+	delete_network(generated_network);
+	generated_network = generate_network(TOPOLOGY_POWER_LAW, 1000, 4.0, 1);
+
+	largest_degree = 0;
+	for (int i = 0; i < generated_network->vertices; i++) {
+		if (generated_network->link_offsets[i + 1] - generated_network->link_offsets[i] > largest_degree) {
+			largest_degree = generated_network->link_offsets[i + 1] - generated_network->link_offsets[i];
+		}
+	}
+
+	printf("1.4 - Expected Result: 1997 links, 1 component, 0 repeated links, largest degree over 20\n");
+	printf(
+		"1.4 - Actual Result: %d links, %d component, %d repeated links, largest degree %s\n",
+		generated_network->link_count / 2,
+		generated_network->component_count,
+		count_repeated_links(generated_network),
+		largest_degree > 20 ? "over 20" : "20 or less"
+	);
+
+	// ----------------------------------------------------------------------------------------------------------------
+	// 2 - Test save_generated_network()
+	// ----------------------------------------------------------------------------------------------------------------
+	printf("----------------\n2. save_generated_network() test\n----------------\n");
+
+	// 2.1 - Test writing a generated network to a file and loading it. It should match the same network generated in memory
+	delete_network(generated_network);
+	delete_network(other_network);
+	generated_network = generate_network(TOPOLOGY_RANDOM, 200, 5.0, 7);
+
+	printf("2.1 - Expected Result: written, 0 differences\n2.1 - Actual Result: ");
+	printf("%s, ", save_generated_network(TOPOLOGY_RANDOM, 200, 5.0, 7, GENERATED_FILE_PATH) ? "written" : "not written");
+
+	other_network = build_network_from_file(GENERATED_FILE_PATH);
+
+	differences = 0;
+	for (int i = 0; i <= generated_network->vertices; i++) {
+		if (other_network->link_offsets[i] != generated_network->link_offsets[i]) {
+			differences++;
+		}
+	}
+	for (int i = 0; i < generated_network->link_count; i++) {
+		if (
+			other_network->packed_links[i].to_device != generated_network->packed_links[i].to_device ||
+			other_network->packed_links[i].speed != generated_network->packed_links[i].speed
+		) {
+			differences++;
+		}
+	}
+	printf("%d differences\n", differences);
+
+	// Free memory
+	delete_network(generated_network);
+	delete_network(other_network);
+	remove(GENERATED_FILE_PATH);
+}
@@ -0,0 +1,120 @@
+// topology.h
+#pragma once
+
+#include <stdint.h>
+
+#include "network.h"
+
+typedef enum {
+	TOPOLOGY_RANDOM = 0,	// A random spanning tree with random links added until the average degree is reached, as network_maker.py makes
+	TOPOLOGY_GRID = 1,		// A square grid, with each device linked to the devices beside and below it
+	TOPOLOGY_POWER_LAW = 2	// Each device is linked to earlier devices that already have more links more often (preferential attachment)
+} TopologyShape;
+
+/**
+ * @struct topologyGenerator
+ * @brief Represents the state of a seeded generator that makes the links of a connected network one at a time
+ *
+ * Contains the shape, size and target number of links of the network, the number of links made so far and the state of
+ * the random number generator (xorshift64*, seeded with splitmix64 so that any seed, including 0, gives a good state).
+ *
+ * For a random network, devices holds the devices in a shuffled order. Each device after the first is linked to a random
+ * device before it to make the spanning tree, and then links are added between random pairs of devices. Every link made
+ * is kept in link_keys, an open addressing hash set of link_key_capacity entries (a power of 2) where 0 is empty, so that
+ * no two devices are linked twice.
+ *
+ * For a power law network, devices holds both ends of every link made so far, so that picking a random entry picks each
+ * device in proportion to its number of links. Each new device is linked to up to attachment_count earlier devices, and
+ * attached holds the ones the current device has been linked to so far.
+ *
+ * next_device, next_attachment and grid_width record where the generator is up to.
+ */
+typedef struct topologyGenerator {
+	TopologyShape shape;
+	int vertices;
+	long long link_target;
+	long long links_made;
+	uint64_t random_state;
+	int* devices;
+	long long device_count;
+	uint64_t* link_keys;
+	size_t link_key_capacity;
+	int* attached;
+	int attachment_count;
+	int next_device;
+	int next_attachment;
+	int grid_width;
+} TopologyGenerator;
+
+/**
+ * @brief Creates a generator for the links of a connected network
+ *
+ * @param shape The shape of the network to make
+ * @param vertices The number of devices in the network
+ * @param average_degree The average number of links each device should have. Grids always have about 4, and power law
+ *                       networks have the nearest even number to it, with at least 2
+ * @param seed The seed of the random numbers, so that the same seed always makes the same network
+ *
+ * @return The new generator
+ */
+TopologyGenerator create_topology_generator(TopologyShape shape, int vertices, double average_degree, uint64_t seed);
+
+/**
+ * @brief Makes the next link of a generated network. Each link is between two different devices, and no two devices are
+ *        linked twice. Speeds are 1, 2, 4 or 8, with the same chances as network_maker.py (10%, 30%, 40% and 20%)
+ *
+ * @param self Pointer to the generator
+ * @param first_device Pointer to where the device at one end of the link is stored
+ * @param second_device Pointer to where the device at the other end of the link is stored
+ * @param speed Pointer to where the speed of the link is stored
+ *
+ * @return Whether a link was made, which is false once every link has been made
+ */
+bool next_topology_link(TopologyGenerator* self, int* first_device, int* second_device, int* speed);
+
+/**
+ * @brief Frees the memory used by a generator
+ *
+ * @param self Pointer to the generator to delete
+ */
+void delete_topology_generator(TopologyGenerator* self);
+
+/**
+ * @brief Generates a connected network straight into memory, without writing a network file
+ *
+ * @param shape The shape of the network to make
+ * @param vertices The number of devices in the network
+ * @param average_degree The average number of links each device should have (see create_topology_generator())
+ * @param seed The seed of the random numbers
+ *
+ * @return Pointer to the new network, which is frozen
+ */
+Network* generate_network(TopologyShape shape, int vertices, double average_degree, uint64_t seed);
+
+/**
+ * @brief Generates a connected network and writes it to a text network file one link at a time, so the links are never all
+ *        in memory at once
+ *
+ * @param shape The shape of the network to make
+ * @param vertices The number of devices in the network
+ * @param average_degree The average number of links each device should have (see create_topology_generator())
+ * @param seed The seed of the random numbers
+ * @param filepath The path of the file to write
+ *
+ * @return Whether the whole file was written
+ */
+bool save_generated_network(TopologyShape shape, int vertices, double average_degree, uint64_t seed, String filepath);
+
+/**
+ * @brief Gets the name of a topology shape, for logging and file names
+ *
+ * @param shape The shape
+ *
+ * @return The name of the shape, or "unknown" if it is not one
+ */
+String get_topology_name(TopologyShape shape);
+
+/**
+ * @brief Tests all of the functions within this file
+ */
+void test_topology();